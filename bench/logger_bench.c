@@ -0,0 +1,356 @@
+#include "logger.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Micro-benchmarks for the LogFlow hot paths.
+//
+// Every measurement times batches of BATCH_OPS operations and reports the
+// throughput plus percentiles of the per-operation cost across batches, so
+// numbers from two releases can be compared line by line.
+//
+// cmake --build . --target logger_bench
+// ./logger_bench [--quick]
+
+#define BATCH_OPS 32
+#define MAX_THREADS 8
+
+typedef struct {
+    const char *name;
+    int pages;
+    int page_size;
+    int msg_size;
+    int threads;
+} bench_case_t;
+
+typedef struct {
+    double *samples;    // ns per operation, one entry per batch
+    int count;
+    int capacity;
+    uint64_t ops;
+    uint64_t elapsed_ns;
+} bench_result_t;
+
+static int g_batches = 20000;
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void result_init(bench_result_t *r, int capacity)
+{
+    r->samples = malloc(sizeof(double) * capacity);
+    r->count = 0;
+    r->capacity = capacity;
+    r->ops = 0;
+    r->elapsed_ns = 0;
+}
+
+static inline void result_add(bench_result_t *r, uint64_t ns, int ops)
+{
+    if (r->count < r->capacity) {
+        r->samples[r->count++] = (double)ns / ops;
+    }
+    r->ops += ops;
+    r->elapsed_ns += ns;
+}
+
+static void result_merge(bench_result_t *into, const bench_result_t *from)
+{
+    for (int i = 0; i < from->count && into->count < into->capacity; i++) {
+        into->samples[into->count++] = from->samples[i];
+    }
+    into->ops += from->ops;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const bench_result_t *r, double p)
+{
+    if (r->count == 0) {
+        return 0.0;
+    }
+    int index = (int)(p * (r->count - 1) + 0.5);
+    return r->samples[index];
+}
+
+static void result_report(const bench_case_t *c, bench_result_t *r, uint64_t wall_ns)
+{
+    qsort(r->samples, r->count, sizeof(double), compare_double);
+    double ops_per_sec = wall_ns ? (double)r->ops * 1e9 / wall_ns : 0.0;
+    printf("%-22s pages=%-4d page=%-6d msg=%-4d threads=%d  %12.0f ops/s  ns/op p50=%7.1f p90=%7.1f p99=%7.1f max=%9.1f\n",
+           c->name, c->pages, c->page_size, c->msg_size, c->threads, ops_per_sec,
+           percentile(r, 0.50), percentile(r, 0.90), percentile(r, 0.99), percentile(r, 1.0));
+    free(r->samples);
+}
+
+// --- Indexed text appends ---
+typedef int (*save_fn)(LoggerHandler, const char *, int, int);
+
+typedef struct {
+    LoggerHandler logger;
+    const bench_case_t *c;
+    save_fn save;
+    int line;           // Appends a '\n' after each message
+    int first_page;     // Threads own disjoint pages, the text path has a single writer per page
+    int page_stride;
+    bench_result_t result;
+} text_worker_t;
+
+static void *text_worker(void *arg)
+{
+    text_worker_t *w = arg;
+    const bench_case_t *c = w->c;
+    char msg[512];
+    memset(msg, 'x', sizeof(msg));
+
+    // Track fill level ourselves so full pages are flushed outside the timed batches
+    const int per_op = c->msg_size + (w->line ? 1 : 0);
+    int *used = calloc(c->pages, sizeof(int));
+    int page = w->first_page;
+
+    result_init(&w->result, g_batches);
+    for (int b = 0; b < g_batches; b++) {
+        if (used[page] + BATCH_OPS * per_op + 2 > c->page_size) {
+            logger_flush_page(w->logger, page);
+            used[page] = 0;
+        }
+        uint64_t start = now_ns();
+        for (int i = 0; i < BATCH_OPS; i++) {
+            w->save(w->logger, msg, c->msg_size, page);
+        }
+        result_add(&w->result, now_ns() - start, BATCH_OPS);
+        used[page] += BATCH_OPS * per_op;
+
+        page += w->page_stride;
+        if (page >= c->pages) {
+            page = w->first_page;
+        }
+    }
+    free(used);
+    return NULL;
+}
+
+static void bench_text(const bench_case_t *c, save_fn save, int line)
+{
+    LoggerHandler logger = logger_create(c->pages, c->page_size);
+    text_worker_t workers[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+
+    uint64_t start = now_ns();
+    for (int t = 0; t < c->threads; t++) {
+        workers[t] = (text_worker_t){ logger, c, save, line, t, c->threads, { 0 } };
+        pthread_create(&threads[t], NULL, text_worker, &workers[t]);
+    }
+    bench_result_t total;
+    result_init(&total, g_batches * c->threads);
+    for (int t = 0; t < c->threads; t++) {
+        pthread_join(threads[t], NULL);
+        result_merge(&total, &workers[t].result);
+        free(workers[t].result.samples);
+    }
+    result_report(c, &total, now_ns() - start);
+    logger_destroy(logger);
+}
+
+// --- Head page records, shared by every thread ---
+typedef struct {
+    LoggerHandler logger;
+    const bench_case_t *c;
+    bench_result_t result;
+} record_worker_t;
+
+static void *record_worker(void *arg)
+{
+    record_worker_t *w = arg;
+    char msg[512];
+    memset(msg, 'r', sizeof(msg));
+
+    result_init(&w->result, g_batches);
+    for (int b = 0; b < g_batches; b++) {
+        uint64_t start = now_ns();
+        for (int i = 0; i < BATCH_OPS; i++) {
+            logger_write(w->logger, msg, w->c->msg_size);
+        }
+        result_add(&w->result, now_ns() - start, BATCH_OPS);
+    }
+    return NULL;
+}
+
+static void bench_records(const bench_case_t *c)
+{
+    LoggerHandler logger = logger_create_ring(c->pages, c->page_size);
+    record_worker_t workers[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+
+    uint64_t start = now_ns();
+    for (int t = 0; t < c->threads; t++) {
+        workers[t] = (record_worker_t){ logger, c, { 0 } };
+        pthread_create(&threads[t], NULL, record_worker, &workers[t]);
+    }
+    bench_result_t total;
+    result_init(&total, g_batches * c->threads);
+    for (int t = 0; t < c->threads; t++) {
+        pthread_join(threads[t], NULL);
+        result_merge(&total, &workers[t].result);
+        free(workers[t].result.samples);
+    }
+    result_report(c, &total, now_ns() - start);
+    logger_destroy(logger);
+}
+
+// --- Flush and print ---
+static int null_sink_write(void *ctx, const char *data, int length)
+{
+    (void)data;
+    *(uint64_t *)ctx += length;
+    return length;
+}
+
+static void fill_pages(LoggerHandler logger, const bench_case_t *c)
+{
+    char msg[512];
+    memset(msg, 'p', sizeof(msg));
+    for (int page = 0; page < c->pages; page++) {
+        for (int used = 0; used + c->msg_size + 3 <= c->page_size; used += c->msg_size + 1) {
+            logger_save_to_page_line(logger, msg, c->msg_size, page);
+        }
+    }
+}
+
+static void bench_flush(const bench_case_t *c, int all)
+{
+    LoggerHandler logger = logger_create(c->pages, c->page_size);
+    const int rounds = g_batches / 20 > 0 ? g_batches / 20 : 1;
+    bench_result_t r;
+    result_init(&r, rounds);
+
+    uint64_t wall = 0;
+    for (int i = 0; i < rounds; i++) {
+        fill_pages(logger, c);
+        uint64_t start = now_ns();
+        if (all) {
+            logger_flush_all(logger);
+        }
+        else {
+            for (int page = 0; page < c->pages; page++) {
+                logger_flush_page(logger, page);
+            }
+        }
+        uint64_t ns = now_ns() - start;
+        wall += ns;
+        result_add(&r, ns, c->pages); // Reported per page
+    }
+    result_report(c, &r, wall);
+    logger_destroy(logger);
+}
+
+static void bench_print(const bench_case_t *c)
+{
+    LoggerHandler logger = logger_create(c->pages, c->page_size);
+    uint64_t bytes = 0;
+    logger_sink_t sink = { null_sink_write, &bytes, NULL };
+    logger_set_sink(logger, &sink);
+    fill_pages(logger, c);
+
+    const int rounds = g_batches / 20 > 0 ? g_batches / 20 : 1;
+    bench_result_t r;
+    result_init(&r, rounds);
+    uint64_t wall = 0;
+    for (int i = 0; i < rounds; i++) {
+        uint64_t start = now_ns();
+        logger_print_all(logger);
+        uint64_t ns = now_ns() - start;
+        wall += ns;
+        result_add(&r, ns, c->pages); // Reported per page
+    }
+    result_report(c, &r, wall);
+    logger_destroy(logger);
+}
+
+static int count_line(void *ctx, const char *line, int length)
+{
+    (void)line;
+    *(uint64_t *)ctx += length;
+    return 0;
+}
+
+static void bench_lines(const bench_case_t *c)
+{
+    LoggerHandler logger = logger_create(c->pages, c->page_size);
+    fill_pages(logger, c);
+
+    const int rounds = g_batches / 20 > 0 ? g_batches / 20 : 1;
+    bench_result_t r;
+    result_init(&r, rounds);
+    uint64_t wall = 0;
+    uint64_t bytes = 0;
+    for (int i = 0; i < rounds; i++) {
+        uint64_t start = now_ns();
+        for (int page = 0; page < c->pages; page++) {
+            logger_page_iterate_lines(logger, page, count_line, &bytes);
+        }
+        uint64_t ns = now_ns() - start;
+        wall += ns;
+        result_add(&r, ns, c->pages); // Reported per page
+    }
+    result_report(c, &r, wall);
+    logger_destroy(logger);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--quick") == 0) {
+        g_batches = 2000;
+    }
+
+    static const int page_counts[] = { 4, 64, 256 };
+    static const int page_sizes[] = { 1024, 16384 };
+    static const int msg_sizes[] = { 16, 64, 256 };
+    static const int thread_counts[] = { 1, 4, 8 };
+
+    printf("LogFlow micro-benchmarks, %d batches of %d ops per case\n", g_batches, BATCH_OPS);
+
+    for (size_t p = 0; p < sizeof(page_counts) / sizeof(page_counts[0]); p++) {
+        for (size_t s = 0; s < sizeof(page_sizes) / sizeof(page_sizes[0]); s++) {
+            for (size_t m = 0; m < sizeof(msg_sizes) / sizeof(msg_sizes[0]); m++) {
+                if (msg_sizes[m] * BATCH_OPS * 2 > page_sizes[s]) {
+                    continue; // A batch would not fit a page
+                }
+                bench_case_t c = { "save_to_page", page_counts[p], page_sizes[s], msg_sizes[m], 1 };
+                bench_text(&c, logger_save_to_page, 0);
+                c.name = "save_to_page_line";
+                bench_text(&c, logger_save_to_page_line, 1);
+            }
+        }
+    }
+
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        bench_case_t c = { "save_to_page_line/mt", 64, 16384, 64, thread_counts[t] };
+        bench_text(&c, logger_save_to_page_line, 1);
+        c.name = "write/mt";
+        bench_records(&c);
+    }
+
+    for (size_t s = 0; s < sizeof(page_sizes) / sizeof(page_sizes[0]); s++) {
+        bench_case_t c = { "flush_page (per page)", 64, page_sizes[s], 64, 1 };
+        bench_flush(&c, 0);
+        c.name = "flush_all (per page)";
+        bench_flush(&c, 1);
+        c.name = "print_all (per page)";
+        bench_print(&c);
+        c.name = "iterate_lines (per page)";
+        bench_lines(&c);
+    }
+    return 0;
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -16,6 +20,16 @@ typedef enum {
     PAGE_TYPE_WARNING,         /**< Warning level logs */
 } page_type_t;
 
+/**
+ * @brief Bit of a page_type_t in a level mask
+ */
+#define LOGGER_LEVEL_MASK(type) (1u << ((int)(type) - PAGE_TYPE_ERROR))
+
+/**
+ * @brief Level mask matching every page_type_t
+ */
+#define LOGGER_LEVEL_ALL 0xFFFFFFFFu
+
 typedef enum {
     LOGGER_DEFAULT = 0,
     LOGGER_FLUSH
@@ -33,6 +47,62 @@ typedef struct logger_t logger_t;
  */
 typedef struct logger_t* LoggerHandler;
 
+/**
+ * @brief Output callback of a sink
+ * @param ctx Context registered with the sink
+ * @param data Contiguous span to write
+ * @param length Number of bytes in the span
+ * @return Number of bytes accepted or a negative value on error
+ */
+typedef int (*logger_sink_write_fn)(void *ctx, const char *data, int length);
+
+/**
+ * @brief Optional end of output notification, buffering sinks send what they hold
+ */
+typedef void (*logger_sink_flush_fn)(void *ctx);
+
+/**
+ * @struct logger_sink_t
+ * @brief Destination of everything the print functions emit
+ */
+typedef struct {
+    logger_sink_write_fn write;     /**< Called with whole spans, never per character */
+    void *ctx;                      /**< Passed back to write */
+    logger_sink_flush_fn flush;     /**< Called after every print call and drained page, may be NULL */
+} logger_sink_t;
+
+/**
+ * @brief Cache line size assumed by LOGGER_LAYOUT_SPLIT, override to match the target
+ */
+#ifndef LOGGER_CACHE_LINE_SIZE
+#define LOGGER_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * @enum logger_layout_t
+ * @brief Placement of the page metadata relative to the page buffers
+ */
+typedef enum {
+    LOGGER_LAYOUT_INLINE = 0,   /**< Metadata right in front of each buffer, most compact (default) */
+    LOGGER_LAYOUT_SPLIT         /**< Metadata in a separate array padded to LOGGER_CACHE_LINE_SIZE,
+                                     so no buffer shares a cache line with the hot counters */
+} logger_layout_t;
+
+/**
+ * @struct logger_config_t
+ * @brief Creation settings for logger_create_ex()
+ */
+typedef struct {
+    int page_amount;            /**< Number of pages to allocate */
+    int page_size;              /**< Size of each page in bytes */
+    int ring;                   /**< Non-zero behaves like logger_create_ring() */
+    logger_layout_t layout;     /**< Metadata placement */
+    int buffer_alignment;       /**< Power of two each buffer starts at, e.g. a DMA boundary;
+                                     0 picks 8 bytes inline and LOGGER_CACHE_LINE_SIZE split */
+} logger_config_t;
+
+#define LOGGER_CONFIG_DEFAULT(pages, size) { (pages), (size), 0, LOGGER_LAYOUT_INLINE, 0 }
+
 /**
  * @brief Creates a new logger with specified number of pages and page size
  * @param page_amount Number of pages to allocate
@@ -41,12 +111,99 @@ typedef struct logger_t* LoggerHandler;
  */
 LoggerHandler logger_create(int page_amount, int page_size);
 
+/**
+ * @brief Creates a logger whose pages form a ring for logger_write()
+ * @param page_amount Number of pages to allocate
+ * @param page_size Size of each page in bytes
+ * @return Handle to the created logger or NULL on failure
+ * @note When the head page fills up, logger_write() moves on to the next page
+ *       and overwrites the oldest one instead of failing.
+ */
+LoggerHandler logger_create_ring(int page_amount, int page_size);
+
+/**
+ * @brief Creates a logger from a full configuration
+ * @param config Settings, start from LOGGER_CONFIG_DEFAULT()
+ * @return Handle to the created logger or NULL on failure (including an alignment
+ *         that is not a power of two)
+ */
+LoggerHandler logger_create_ex(const logger_config_t *config);
+
+/**
+ * @brief Bookkeeping bytes of a logger, upper bounds checked when the library is built
+ */
+#define LOGGER_STATIC_BASE_SIZE 512
+#define LOGGER_STATIC_PAGE_OVERHEAD 128
+
+/**
+ * @brief Bytes logger_create_static() needs for pages pages of size bytes
+ * @note A compile-time constant for constant arguments, so it can size a static array.
+ *       It bounds LOGGER_ALLOC_SIZE() from above and covers an unaligned region start.
+ */
+#define LOGGER_REQUIRED_SIZE(pages, size) \
+    ((size_t)LOGGER_STATIC_BASE_SIZE \
+    + (size_t)(pages) * (LOGGER_STATIC_PAGE_OVERHEAD + (((size_t)(size) + 7u) & ~(size_t)7u)))
+
+/**
+ * @brief Creates a logger inside caller-provided memory, without any heap allocation
+ * @param mem Start of the region, any alignment (PSRAM, RTC memory, a linker section...)
+ * @param len Size of the region, LOGGER_REQUIRED_SIZE(page_amount, page_size) is always enough
+ * @param page_amount Number of pages
+ * @param page_size Size of each page in bytes
+ * @return Handle to the logger, placed inside mem, or NULL if the region is too small
+ * @note logger_destroy() stops a drain worker if one runs but leaves the memory to the caller.
+ */
+LoggerHandler logger_create_static(void *mem, size_t len, int page_amount, int page_size);
+
+/**
+ * @brief Re-adopts a logger that a previous run built in mem, keeping its pages
+ * @param mem Region given to logger_create_static() before the reset
+ * @param len Size of the region
+ * @return Handle to the recovered logger, or NULL when mem holds no valid logger
+ * @note Place the region in memory that survives a reset without being cleared
+ *       (RTC_NOINIT_ATTR / a .noinit section) and call this at boot before
+ *       logger_create_static(). The header magic, geometry and CRC are checked;
+ *       page contents are not rewritten. Records stop at the first one that was
+ *       not committed when the reset hit, writing continues on the last head page.
+ *       Deferred records render as before when the same image attaches; after a
+ *       reflash they print as "<deferred record lost>", their formats are gone.
+ *       The sink is back to stdout and no drain worker runs. Regions released
+ *       with logger_destroy() are not attached again.
+ */
+LoggerHandler logger_attach_existing(void *mem, size_t len);
+
+/**
+ * @brief Creates a logger whose arena is a memory-mapped file (host builds only)
+ * @param path File holding the logs, created when missing
+ * @param page_amount Number of pages
+ * @param page_size Size of each page in bytes
+ * @return Handle to the logger or NULL on failure (always NULL on ESP-IDF)
+ * @note A file left by a previous run with the same geometry is attached, its pages
+ *       kept; otherwise the file is resized and started empty. The OS page cache does
+ *       the I/O, and every page logger_write() moves away from is msync()'d with
+ *       MS_ASYNC. Other processes may map the file read-only and follow it, see
+ *       tools/logger_tail.c. logger_destroy() syncs and unmaps but keeps the file.
+ *       Deferred records of an earlier run render when the executable is loaded at
+ *       the same address; a PIE executable under ASLR moves every run, and then
+ *       they print as "<deferred record lost>". The file is never rewritten for it.
+ */
+LoggerHandler logger_create_mapped(const char *path, int page_amount, int page_size);
+
 /**
  * @brief Destroys a logger and frees all associated resources
  * @param logger Logger to destroy
  */
 void logger_destroy(LoggerHandler logger);
 
+/**
+ * @brief Routes the output of the print functions to a custom sink
+ * @param logger Logger instance
+ * @param sink Sink to copy, NULL restores the default stdout sink
+ * @note Print functions stage small pieces in a stack buffer and pass large
+ *       contiguous spans, such as a page of text, to the sink in one call.
+ */
+void logger_set_sink(LoggerHandler logger, const logger_sink_t *sink);
+
 void logger_print_page_line(LoggerHandler logger, int page_index);
 
 /**
@@ -62,6 +219,38 @@ void logger_print_page(LoggerHandler logger, int page_index, logger_command_t co
  */
 void logger_print_all(LoggerHandler logger);
 
+/**
+ * @brief Receives one line of a page, without its line break
+ * @return 0 to continue, non-zero to stop the iteration
+ */
+typedef int (*logger_line_fn)(void *ctx, const char *line, int length);
+
+/**
+ * @brief Calls fn for every line of a page, in order
+ * @param logger Logger instance
+ * @param page_index Page to read
+ * @param fn Line callback, the line points into the page and is not null-terminated
+ * @param ctx Passed back to fn
+ * @return Number of lines visited, or -1 on error
+ * @note Text pages are split on '\n' with vectorized scanning (SSE2/NEON, scalar
+ *       elsewhere). Record pages give one line per record payload; deferred
+ *       records are rendered into a LOGGER_LINE_RENDER_SIZE stack buffer first.
+ */
+int logger_page_iterate_lines(LoggerHandler logger, int page_index, logger_line_fn fn, void *ctx);
+
+/**
+ * @brief Number of lines logger_page_iterate_lines() would visit, or -1 on error
+ */
+int logger_page_count_lines(LoggerHandler logger, int page_index);
+
+/**
+ * @brief Prints only the records whose level is in level_mask, oldest first
+ * @param logger Logger instance
+ * @param level_mask OR of LOGGER_LEVEL_MASK() values
+ * @note Text pages are filtered by their page type as a whole.
+ */
+void logger_print_filtered(LoggerHandler logger, uint32_t level_mask);
+
 /**
  * @brief Dumps detailed memory information about the logger (for debugging)
  * @param logger Logger instance
@@ -89,6 +278,771 @@ int logger_save_to_page(LoggerHandler logger, const char *data, int size, int in
  */
 int logger_save_to_page_line(LoggerHandler logger, const char *data, int size, int index);
 
+/**
+ * @brief Appends one record to a page, safe to call from several producers at once
+ * @param logger Logger instance
+ * @param data Pointer to the data to save
+ * @param size Size of data in bytes (if ≤0, strlen(data) is used)
+ * @param index Page index to save to
+ * @return Number of bytes written or -1 on error
+ * @note Space is reserved with an atomic fetch-add and the record is published
+ *       with a commit marker, so readers never see a partially written record.
+ *       Records are never truncated: if the page cannot hold the whole record,
+ *       nothing is written and -1 is returned. A page holds either records or
+ *       plain text from logger_save_to_page*() until it is flushed.
+ */
+int logger_append_atomic(LoggerHandler logger, const char *data, int size, int index);
+
+/**
+ * @struct logger_iov
+ * @brief One fragment of a vectored append
+ */
+struct logger_iov {
+    const char *base;   /**< Fragment data */
+    int length;         /**< Bytes in base, ≤0 uses strlen(base) */
+};
+
+/**
+ * @brief Appends several fragments to a page as one piece of text
+ * @param logger Logger instance
+ * @param iov Fragments, written back to back in order
+ * @param count Number of fragments
+ * @param index Page index to save to
+ * @return Number of bytes written, 0 if the page is full, or -1 on error
+ * @note Same as one logger_save_to_page() call with the concatenation: a single
+ *       space check, offset update and null terminator, truncated to fit.
+ */
+int logger_save_iov(LoggerHandler logger, const struct logger_iov *iov, int count, int index);
+
+/**
+ * @brief Appends one record to the current head page, moving to the next page when full
+ * @param logger Logger instance
+ * @param data Pointer to the data to save
+ * @param size Size of data in bytes (if ≤0, strlen(data) is used)
+ * @return Number of bytes written or -1 on error
+ * @note Records are never truncated. Ring loggers overwrite the oldest page;
+ *       other loggers return -1 once the last page is full. Safe to call from
+ *       several producers at once.
+ */
+int logger_write(LoggerHandler logger, const char *data, int size);
+
+/**
+ * @brief Same as logger_write() with a severity level stored in the record header
+ * @param logger Logger instance
+ * @param level Severity of this record
+ * @param data Pointer to the data to save
+ * @param size Size of data in bytes (if ≤0, strlen(data) is used)
+ * @return Number of bytes written or -1 on error
+ * @note Every record carries its own level and a monotonic timestamp, so levels
+ *       can be mixed freely on a page and filtered per record.
+ */
+int logger_log(LoggerHandler logger, page_type_t level, const char *data, int size);
+
+/**
+ * @brief Same as logger_log() with the payload gathered from several fragments
+ * @return Number of bytes stored, 0 when filtered by logger_set_level(), -1 on error
+ * @note One reservation for the whole record, which readers see complete or not at all.
+ */
+int logger_log_iov(LoggerHandler logger, page_type_t level, const struct logger_iov *iov, int count);
+
+/**
+ * @brief Logs many records of one level in one call, e.g. messages queued by an ISR
+ * @param messages One fragment per record
+ * @param count Number of records
+ * @return Number of records stored, which stops short when the logger runs out of room;
+ *         -1 on error
+ * @note When the batch fits the head page it takes a single reservation and shares one
+ *       timestamp, so it stays contiguous; otherwise each record is logged on its own.
+ */
+int logger_log_batch(LoggerHandler logger, page_type_t level, const struct logger_iov *messages, int count);
+
+/**
+ * @brief Reserves space for one record on the head page so it can be filled in place
+ * @param logger Logger instance
+ * @param size Number of bytes to reserve
+ * @param ptr Receives a pointer to the reserved bytes inside the page
+ * @return 0 on success or -1 on error (size larger than a page, or no page left)
+ * @note The record stays invisible to readers, and blocks the records after it
+ *       from being read, until logger_commit() is called, so commit promptly.
+ */
+int logger_reserve(LoggerHandler logger, int size, char **ptr);
+
+/**
+ * @brief Publishes a record obtained from logger_reserve()
+ * @param logger Logger instance
+ * @param ptr Pointer returned by logger_reserve()
+ * @param used Bytes actually written (≤ reserved size); 0 discards the record
+ * @return Number of bytes committed or -1 on error
+ */
+int logger_commit(LoggerHandler logger, char *ptr, int used);
+
+/**
+ * @brief Logs a printf-style message without formatting it on the caller
+ * @param logger Logger instance
+ * @param fmt printf-style format string, must stay valid for the lifetime of the logger
+ * @return Number of bytes stored or -1 on error
+ * @note Only the format pointer and the raw argument bytes are stored (%s arguments
+ *       are copied). Formatting happens in logger_print_page() and logger_print_all().
+ *       The record goes to the head page like logger_write(). %n, %ls, %lc and specs
+ *       longer than 31 characters once their '*' values are expanded are rejected.
+ */
+int logger_logf_deferred(LoggerHandler logger, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Same as logger_logf_deferred() with a severity level stored in the record header
+ */
+int logger_logf_deferred_level(LoggerHandler logger, page_type_t level, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief va_list variant of logger_logf_deferred_level()
+ */
+int logger_vlogf_deferred(LoggerHandler logger, page_type_t level, const char *fmt, va_list args);
+
+// --- Level filtering ---
+
+/**
+ * @brief Severity ranks, page_type_t values are not ordered by severity
+ */
+#define LOGFLOW_LEVEL_DEBUG     0
+#define LOGFLOW_LEVEL_INFO      1
+#define LOGFLOW_LEVEL_DEFAULT   2
+#define LOGFLOW_LEVEL_WARNING   3
+#define LOGFLOW_LEVEL_ERROR     4
+#define LOGFLOW_LEVEL_NONE      5   /**< Threshold disabling every level */
+
+/**
+ * @brief Severity rank of a page_type_t, a constant expression for constant arguments
+ */
+#define LOGFLOW_LEVEL_RANK(type) \
+    ((type) == PAGE_TYPE_ERROR ? LOGFLOW_LEVEL_ERROR \
+    : (type) == PAGE_TYPE_WARNING ? LOGFLOW_LEVEL_WARNING \
+    : (type) == PAGE_TYPE_DEFAULT ? LOGFLOW_LEVEL_DEFAULT \
+    : (type) == PAGE_TYPE_INFO ? LOGFLOW_LEVEL_INFO : LOGFLOW_LEVEL_DEBUG)
+
+/**
+ * @brief Lowest rank the LOGF_*() macros compile in, define it before including logger.h
+ *        or on the command line, e.g. -DLOGFLOW_MIN_LEVEL=LOGFLOW_LEVEL_WARNING
+ */
+#ifndef LOGFLOW_MIN_LEVEL
+#define LOGFLOW_MIN_LEVEL LOGFLOW_LEVEL_DEBUG
+#endif
+
+/**
+ * @brief Sets the lowest level records are kept for at run time
+ * @param logger Logger instance
+ * @param min_level Records less severe than this are dropped, PAGE_TYPE_INFO_DEBUG keeps all (default)
+ * @note Checked first thing by logger_log(), logger_write() and the deferred functions,
+ *       before any argument is packed. A dropped record returns 0.
+ */
+void logger_set_level(LoggerHandler logger, page_type_t min_level);
+
+/**
+ * @brief Non-zero when a record of this level passes the run time threshold
+ */
+int logger_level_enabled(LoggerHandler logger, page_type_t level);
+
+/**
+ * @struct logger_overflow_t
+ * @brief Free pages kept back from the lower levels, see logger_set_overflow()
+ */
+typedef struct {
+    int reserved_pages;     /**< Last free pages only warnings and errors may take */
+    int debug_pages;        /**< Further free pages closed to debug records, so debug goes first */
+} logger_overflow_t;
+
+#define LOGGER_OVERFLOW_DEFAULT(pages) { (pages), (pages) }
+
+/**
+ * @brief Drops low level records before the logger runs out of pages
+ * @param policy Pages to keep back, NULL turns the policy off
+ * @return 0 on success, -1 when the reserve leaves no page for info records
+ * @note Applied when the head page is full and the records would need a new one, so
+ *       appends that fit the head page cost nothing more. Free pages are those left
+ *       before a linear logger ends or, with logger_drain_start(), before the pages
+ *       still waiting for the worker. Debug records are refused once
+ *       reserved_pages + debug_pages or fewer are free, info and default records once
+ *       reserved_pages or fewer are; both count as drops and as shed in
+ *       logger_get_stats(). Ring loggers without a drain worker overwrite their
+ *       oldest page by design and never run short. Text written with
+ *       logger_save_to_page*() goes to the page the caller names and is not affected.
+ */
+int logger_set_overflow(LoggerHandler logger, const logger_overflow_t *policy);
+
+/**
+ * @brief Deferred printf-style logging filtered at compile time by LOGFLOW_MIN_LEVEL
+ * @note Levels below LOGFLOW_MIN_LEVEL expand to ((void)0): no call is made and the
+ *       arguments are not evaluated, so they must not carry needed side effects.
+ *       Enabled levels call logger_logf_deferred_level(), which applies logger_set_level().
+ */
+#if LOGFLOW_MIN_LEVEL <= LOGFLOW_LEVEL_ERROR
+#define LOGF_ERROR(logger, ...) logger_logf_deferred_level((logger), PAGE_TYPE_ERROR, __VA_ARGS__)
+#else
+#define LOGF_ERROR(logger, ...) ((void)0)
+#endif
+
+#if LOGFLOW_MIN_LEVEL <= LOGFLOW_LEVEL_WARNING
+#define LOGF_WARNING(logger, ...) logger_logf_deferred_level((logger), PAGE_TYPE_WARNING, __VA_ARGS__)
+#else
+#define LOGF_WARNING(logger, ...) ((void)0)
+#endif
+
+#if LOGFLOW_MIN_LEVEL <= LOGFLOW_LEVEL_DEFAULT
+#define LOGF_LOG(logger, ...) logger_logf_deferred_level((logger), PAGE_TYPE_DEFAULT, __VA_ARGS__)
+#else
+#define LOGF_LOG(logger, ...) ((void)0)
+#endif
+
+#if LOGFLOW_MIN_LEVEL <= LOGFLOW_LEVEL_INFO
+#define LOGF_INFO(logger, ...) logger_logf_deferred_level((logger), PAGE_TYPE_INFO, __VA_ARGS__)
+#else
+#define LOGF_INFO(logger, ...) ((void)0)
+#endif
+
+#if LOGFLOW_MIN_LEVEL <= LOGFLOW_LEVEL_DEBUG
+#define LOGF_DEBUG(logger, ...) logger_logf_deferred_level((logger), PAGE_TYPE_INFO_DEBUG, __VA_ARGS__)
+#else
+#define LOGF_DEBUG(logger, ...) ((void)0)
+#endif
+
+/**
+ * @brief Writes a record carrying a tag, e.g. the component name, for logger_query_tag()
+ * @param logger Logger instance
+ * @param level Level of the record
+ * @param tag Null-terminated tag, stored in front of the payload as "tag: " unless it was
+ *            registered with logger_tag_register()
+ * @param data Payload
+ * @param size Payload length, 0 or less for strlen(data)
+ * @return Payload bytes written, 0 when filtered by logger_set_level(), -1 on error
+ */
+int logger_log_tag(LoggerHandler logger, page_type_t level, const char *tag, const char *data, int size);
+
+/**
+ * @brief Registers a tag so records refer to it instead of carrying a copy
+ * @param tag Null-terminated tag that stays valid and unchanged for the life of the
+ *            program, usually a string literal; it is kept by pointer
+ * @return Tag ID for logger_log_tag_id(), the same for the same string, or -1 when the
+ *         registry is full (LOGGER_TAGS_MAX, 64 by default) or another tag has the same hash
+ * @note The registry is shared by all loggers and safe to use from any thread. Records
+ *       of registered tags print, export and match logger_query_tag() as before, with the
+ *       tag expanded by the reader; a program that did not register it shows "#hhhh".
+ */
+int logger_tag_register(const char *tag);
+
+/**
+ * @brief Same as logger_log_tag() for a tag registered before, without hashing it
+ * @param tag_id ID returned by logger_tag_register()
+ * @return Payload bytes written, 0 when filtered by logger_set_level(), -1 on error or
+ *         for an ID that was not registered
+ */
+int logger_log_tag_id(LoggerHandler logger, page_type_t level, int tag_id, const char *data, int size);
+
+/**
+ * @struct logger_page_summary_t
+ * @brief What a record page holds, kept up to date while records are written
+ */
+typedef struct {
+    int records;                            /**< Records reserved on the page */
+    unsigned int counts[LOGFLOW_LEVEL_NONE]; /**< Records per LOGFLOW_LEVEL_* rank */
+    uint32_t first_us;                      /**< Timestamp of the earliest record */
+    uint32_t last_us;                       /**< Timestamp of the latest record */
+    uint32_t tags;                          /**< Bloom filter bits of the record tags */
+} logger_page_summary_t;
+
+/**
+ * @brief Reads the summary of a page
+ * @return 0 on success, -1 on error or when the page holds no records
+ */
+int logger_get_page_summary(LoggerHandler logger, int page_index, logger_page_summary_t *summary);
+
+/**
+ * @struct logger_time_range_t
+ * @brief Inclusive range of logger_now_us() timestamps, compared across the 32-bit wrap
+ */
+typedef struct {
+    uint32_t from_us;
+    uint32_t to_us;
+} logger_time_range_t;
+
+/**
+ * @struct logger_record_t
+ * @brief One record handed to a query callback
+ */
+typedef struct {
+    uint32_t timestamp;     /**< logger_now_us() when the record was written */
+    page_type_t level;
+    int page;               /**< Index of the page holding it */
+    const char *data;       /**< Payload, not null-terminated; deferred records are rendered */
+    int length;
+} logger_record_t;
+
+/**
+ * @brief Query callback
+ * @return 0 to continue, non-zero to stop the query
+ */
+typedef int (*logger_record_fn)(void *ctx, const logger_record_t *record);
+
+/**
+ * @brief Calls fn for every record matching level_mask and range, oldest first
+ * @param logger Logger instance
+ * @param level_mask OR of LOGGER_LEVEL_MASK() values
+ * @param range Timestamps to keep, NULL for all
+ * @param fn Record callback
+ * @param ctx Passed back to fn
+ * @return Number of records passed to fn, or -1 on error
+ * @note Pages whose summary holds no matching level or lies outside the range are
+ *       skipped without reading them. Only record pages are searched, text pages
+ *       carry no per-record level or time.
+ */
+int logger_query(LoggerHandler logger, uint32_t level_mask, const logger_time_range_t *range,
+                 logger_record_fn fn, void *ctx);
+
+/**
+ * @brief Same as logger_query(), limited to records written by logger_log_tag() with tag
+ * @note Tags are matched by a 16-bit hash, pages are skipped by their tag bloom filter.
+ */
+int logger_query_tag(LoggerHandler logger, const char *tag, uint32_t level_mask,
+                     const logger_time_range_t *range, logger_record_fn fn, void *ctx);
+
+/**
+ * @enum logger_stream_format_t
+ * @brief What a stream of pages looks like on the wire
+ */
+typedef enum {
+    LOGGER_FORMAT_TEXT = 0,     /**< Lines as the print functions write them */
+    LOGGER_FORMAT_FRAMES        /**< logger_export() frames, records are not rendered to text */
+} logger_stream_format_t;
+
+/**
+ * @struct logger_drain_config_t
+ * @brief Settings of the background drain worker
+ */
+typedef struct {
+    int high_watermark;     /**< Full pages waiting before the worker wakes up (default 1) */
+    int low_watermark;      /**< The worker stops once no more than this many pages wait (default 0) */
+    int interval_ms;        /**< Also wake up this often, 0 wakes on the high watermark only */
+    int stack_size;         /**< Task stack in bytes, FreeRTOS only */
+    int priority;           /**< Task priority, FreeRTOS only */
+    logger_stream_format_t format; /**< How pages reach the sink (default LOGGER_FORMAT_TEXT) */
+} logger_drain_config_t;
+
+#define LOGGER_DRAIN_CONFIG_DEFAULT { 1, 0, 0, 4096, 5, LOGGER_FORMAT_TEXT }
+
+/**
+ * @brief Starts a background worker writing filled pages to the logger's sink
+ * @param logger Logger instance with at least two pages
+ * @param config Worker settings, NULL for LOGGER_DRAIN_CONFIG_DEFAULT
+ * @return 0 on success, -1 on error
+ * @note Uses a pthread on POSIX and a FreeRTOS task on ESP-IDF. Pages filled by
+ *       logger_write(), logger_log(), logger_reserve() and logger_logf_deferred()
+ *       are queued for the worker while producers continue on the next page.
+ *       Once a page is written out it is reused, so a non-ring logger no longer
+ *       stops at its last page. When every page is waiting, ring loggers drop the
+ *       oldest page and other loggers drop the new record.
+ */
+int logger_drain_start(LoggerHandler logger, const logger_drain_config_t *config);
+
+/**
+ * @brief Blocks until every written record, the partly filled head page included, reached the sink
+ * @param logger Logger instance
+ * @return 0 on success, -1 if no drain worker runs
+ */
+int logger_drain_sync(LoggerHandler logger);
+
+/**
+ * @brief Drains what is left and stops the worker, called by logger_destroy() as well
+ * @param logger Logger instance
+ */
+void logger_drain_stop(LoggerHandler logger);
+
+/**
+ * @brief Sets up the interrupt rings used by logger_isr_log(), one per core
+ * @param ring_size Bytes per ring, rounded up to a power of two
+ * @return 0 on success, -1 when already enabled, too small or out of memory
+ * @note Call it before any interrupt handler may log; the rings live until logger_destroy().
+ */
+int logger_isr_enable(LoggerHandler logger, int ring_size);
+
+/**
+ * @brief Logs from an interrupt handler, or a POSIX signal handler
+ * @return Bytes stored, 0 when filtered by logger_set_level(), -1 when the ring is full,
+ *         busy with a nested interrupt or the record longer than half a ring
+ * @note Never blocks, takes no lock and does not touch the pages: the record is copied
+ *       to the ring of the current core with its timestamp and merged later. Placed in
+ *       IRAM on ESP-IDF. Rejected records count as drops.
+ */
+int logger_isr_log(LoggerHandler logger, page_type_t level, const char *data, int size);
+
+/**
+ * @brief Moves the records of the interrupt rings to the pages, from task context
+ * @return Records merged, -1 when the rings are not enabled
+ * @note The drain worker merges on every pass and in logger_drain_sync(), and a ring
+ *       half full wakes it, so only loggers without a worker need to call this, e.g.
+ *       before printing. Records keep the time they were logged at but land after
+ *       those written by tasks in the meantime.
+ */
+int logger_isr_merge(LoggerHandler logger);
+
+/**
+ * @enum logger_net_transport_t
+ */
+typedef enum {
+    LOGGER_NET_UDP = 0,         /**< One datagram per batch, whole lines or frames whenever they fit */
+    LOGGER_NET_TCP              /**< One write per batch, reconnects after errors */
+} logger_net_transport_t;
+
+/**
+ * @enum logger_net_policy_t
+ * @brief What a network sink does when its queue is full
+ */
+typedef enum {
+    LOGGER_NET_DROP_OLDEST = 0, /**< Drop the oldest queued lines or frames, writers never wait */
+    LOGGER_NET_BLOCK            /**< Make the writer wait for the network, e.g. the drain worker */
+} logger_net_policy_t;
+
+/**
+ * @struct logger_net_config_t
+ * @brief Settings of a network sink
+ */
+typedef struct {
+    const char *host;               /**< Collector name or address, copied */
+    int port;
+    logger_net_transport_t transport;
+    logger_net_policy_t policy;
+    logger_stream_format_t format;  /**< Must match what the logger writes, e.g. the drain format */
+    int batch_size;                 /**< Bytes per datagram or write (default 1400, one Ethernet frame) */
+    int queue_size;                 /**< Bytes queued while the network is slow (default 8192) */
+    int block_ms;                   /**< LOGGER_NET_BLOCK: longest wait before dropping anyway, negative waits forever */
+} logger_net_config_t;
+
+#define LOGGER_NET_CONFIG_DEFAULT(host, port) \
+    { (host), (port), LOGGER_NET_UDP, LOGGER_NET_DROP_OLDEST, LOGGER_FORMAT_TEXT, 1400, 8192, -1 }
+
+/**
+ * @struct logger_net_stats_t
+ */
+typedef struct {
+    unsigned long sent_bytes;       /**< Bytes handed to the socket */
+    unsigned long sends;            /**< Datagrams or writes */
+    unsigned long dropped_bytes;    /**< Bytes dropped by the policy or lost to send errors */
+    unsigned long errors;           /**< Failed sends and connects */
+    int connected;                  /**< Non-zero while the socket is open */
+} logger_net_stats_t;
+
+typedef struct logger_net logger_net_t;
+
+/**
+ * @brief Opens a sink streaming to a remote collector
+ * @param config Settings, start from LOGGER_NET_CONFIG_DEFAULT()
+ * @return Handle, or NULL on invalid settings or allocation failure
+ * @note The connection is made here and made again after errors, at most once a
+ *       second. Writes are queued and go out in batches of batch_size, cut at line
+ *       or frame boundaries, so no record costs a system call of its own. Pair it
+ *       with logger_drain_start() to keep the sends off the producers; with
+ *       LOGGER_FORMAT_FRAMES in both configs records are not rendered to text and
+ *       logger_decode reads the stream.
+ */
+logger_net_t *logger_net_open(const logger_net_config_t *config);
+
+/**
+ * @brief Sink writing to net, pass it to logger_set_sink()
+ */
+logger_sink_t logger_net_sink(logger_net_t *net);
+
+/**
+ * @brief Sends everything queued
+ * @param timeout_ms Longest wait, 0 only sends what the socket takes right away
+ * @return 0 once the queue is empty, -1 otherwise
+ */
+int logger_net_flush(logger_net_t *net, int timeout_ms);
+
+/**
+ * @brief Reads the counters of a network sink
+ */
+int logger_net_get_stats(logger_net_t *net, logger_net_stats_t *stats);
+
+/**
+ * @brief Flushes for at most a second and closes the sink; detach it from every logger first
+ */
+void logger_net_close(logger_net_t *net);
+
+/**
+ * @struct logger_shards_t
+ * @brief Set of loggers, one per core or thread, read back as a single timeline
+ */
+typedef struct logger_shards_t logger_shards_t;
+
+/**
+ * @typedef LoggerShardsHandler
+ * @brief Handle to a sharded logger
+ */
+typedef struct logger_shards_t* LoggerShardsHandler;
+
+/**
+ * @brief Creates shard_count loggers with logger_create(), one per core or thread
+ * @param shard_count Number of shards, typically the core or producer thread count
+ * @param page_amount Number of pages of each shard
+ * @param page_size Size of each page in bytes
+ * @return Handle to the shards or NULL on failure
+ * @note Each shard has its own allocation, head page and counters, so producers
+ *       writing through logger_shards_local() never share writable cache lines.
+ */
+LoggerShardsHandler logger_shards_create(int shard_count, int page_amount, int page_size);
+
+/**
+ * @brief Same as logger_shards_create() with ring loggers from logger_create_ring()
+ */
+LoggerShardsHandler logger_shards_create_ring(int shard_count, int page_amount, int page_size);
+
+/**
+ * @brief Destroys every shard and the shard set
+ */
+void logger_shards_destroy(LoggerShardsHandler shards);
+
+/**
+ * @brief Number of shards
+ */
+int logger_shards_count(LoggerShardsHandler shards);
+
+/**
+ * @brief Gets one shard, e.g. to start a drain worker on it
+ * @return Logger of the shard or NULL if the index is out of range
+ */
+LoggerHandler logger_shards_get(LoggerShardsHandler shards, int index);
+
+/**
+ * @brief Shard of the calling thread (of the current core on ESP-IDF)
+ * @note Threads beyond the shard count share shards; that stays correct since
+ *       record appends are safe from several producers, it is only slower.
+ */
+LoggerHandler logger_shards_local(LoggerShardsHandler shards);
+
+/**
+ * @brief logger_write() on the shard of the calling thread
+ */
+int logger_shards_write(LoggerShardsHandler shards, const char *data, int size);
+
+/**
+ * @brief logger_log() on the shard of the calling thread
+ */
+int logger_shards_log(LoggerShardsHandler shards, page_type_t level, const char *data, int size);
+
+/**
+ * @brief logger_logf_deferred_level() on the shard of the calling thread
+ */
+int logger_shards_logf_deferred(LoggerShardsHandler shards, page_type_t level, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief Routes the output of every shard, and of the merged readout, to sink
+ */
+void logger_shards_set_sink(LoggerShardsHandler shards, const logger_sink_t *sink);
+
+/**
+ * @brief logger_set_level() on every shard
+ */
+void logger_shards_set_level(LoggerShardsHandler shards, page_type_t min_level);
+
+/**
+ * @brief Prints the records of all shards interleaved by timestamp, oldest first
+ * @note Only records are merged; text written with logger_save_to_page*() to a
+ *       shard carries no timestamp and is left out.
+ */
+void logger_shards_print_all(LoggerShardsHandler shards);
+
+/**
+ * @brief Same as logger_shards_print_all() keeping only the levels in level_mask
+ */
+void logger_shards_print_filtered(LoggerShardsHandler shards, uint32_t level_mask);
+
+/**
+ * @struct logger_group_t
+ * @brief Named loggers carved out of one allocation, sharing a pool of spare pages
+ */
+typedef struct logger_group_t logger_group_t;
+
+/**
+ * @typedef LoggerGroupHandler
+ * @brief Handle to a logger group
+ */
+typedef struct logger_group_t* LoggerGroupHandler;
+
+#define LOGGER_GROUP_NAME_SIZE 16   /**< Bytes of a member name, terminator included */
+
+/**
+ * @struct logger_group_config_t
+ * @brief Geometry of a logger group, fixed at creation
+ */
+typedef struct {
+    int max_loggers;            /**< Members the group can hold */
+    int base_pages;             /**< Pages every member keeps for itself, at least 2 */
+    int shared_pages;           /**< Pages lent to whichever member runs short, rounded down to slab_pages */
+    int page_size;              /**< Size of each page in bytes, the same for every member */
+    int slab_pages;             /**< Pages lent at a time (default 2) */
+    int ring;                   /**< Non-zero makes every member a ring logger */
+} logger_group_config_t;
+
+#define LOGGER_GROUP_CONFIG_DEFAULT(loggers, shared, size) { (loggers), 2, (shared), (size), 2, 0 }
+
+/**
+ * @brief Allocates a group: the base pages of every member and the shared pages, in one block
+ * @param config Geometry, start from LOGGER_GROUP_CONFIG_DEFAULT()
+ * @return Handle to the group or NULL on failure
+ */
+LoggerGroupHandler logger_group_create(const logger_group_config_t *config);
+
+/**
+ * @brief Destroys every member, stops the group drain worker and frees the block
+ */
+void logger_group_destroy(LoggerGroupHandler group);
+
+/**
+ * @brief Creates a member logger inside the group
+ * @param name Name of the member, shorter than LOGGER_GROUP_NAME_SIZE, copied
+ * @return Handle, usable like any logger, or NULL when the group is full or the name taken
+ * @note A member that runs out of base pages borrows slab_pages shared pages at a time,
+ *       like logger_set_growth() does from the heap. logger_group_shrink() takes them back.
+ */
+LoggerHandler logger_group_add(LoggerGroupHandler group, const char *name);
+
+/**
+ * @brief Member of the given name, NULL when there is none
+ */
+LoggerHandler logger_group_get(LoggerGroupHandler group, const char *name);
+
+/**
+ * @brief Destroys a member, its borrowed pages go back to the group
+ * @return 0 on success, -1 when there is no such member
+ * @note The caller makes sure no other thread still logs through it.
+ */
+int logger_group_remove(LoggerGroupHandler group, const char *name);
+
+/**
+ * @brief Runs logger_shrink() on every member
+ * @return Pages handed back to the group, -1 on invalid arguments
+ * @note Call it from a timer: pages return once they stayed idle across two calls.
+ */
+int logger_group_shrink(LoggerGroupHandler group);
+
+/**
+ * @brief Shared pages not lent to any member right now, -1 on invalid arguments
+ */
+int logger_group_free_pages(LoggerGroupHandler group);
+
+/**
+ * @brief Starts one drain worker for every member, present and added later
+ * @param config Worker settings, NULL for LOGGER_DRAIN_CONFIG_DEFAULT
+ * @return 0 on success, -1 on error or if it already runs
+ * @note Each member writes to its own sink. logger_drain_sync() on a member still
+ *       waits for its pages; logger_drain_stop() on one only detaches it.
+ */
+int logger_group_drain_start(LoggerGroupHandler group, const logger_drain_config_t *config);
+
+/**
+ * @brief Writes out what every member queued and stops the group drain worker
+ */
+void logger_group_drain_stop(LoggerGroupHandler group);
+
+// --- Binary export ---
+
+/**
+ * @brief Largest text frame, bounds the decoder buffer for text pages
+ */
+#ifndef LOGGER_EXPORT_CHUNK
+#define LOGGER_EXPORT_CHUNK 512
+#endif
+
+/**
+ * @brief Decoder buffer needed for the compressed 'Z' frames of pages of page_size bytes
+ * @note A 'Z' frame is decompressed behind its own payload in the decoder buffer, so it
+ *       takes the compressed page plus the page serialized, up to 2 * page_size + 64 bytes.
+ */
+#define LOGGER_DECODER_ARCHIVE_SIZE(page_size) \
+    (4 + 2 * (2 * (page_size) + 64) + (2 * (page_size) + 64) / 255 + 16)
+
+/**
+ * @enum logger_export_event_t
+ * @brief What a decoded frame of an export stream carries
+ */
+typedef enum {
+    LOGGER_EXPORT_HEADER,   /**< Start of a stream: version, page_size, page_count */
+    LOGGER_EXPORT_PAGE,     /**< Following text or records belong to page_index */
+    LOGGER_EXPORT_TEXT,     /**< Chunk of raw page text in data/length */
+    LOGGER_EXPORT_RECORD,   /**< One record: timestamp, level in type, payload in data/length */
+    LOGGER_EXPORT_END       /**< End of a stream, checksum verified */
+} logger_export_event_t;
+
+/**
+ * @struct logger_export_item_t
+ * @brief One decoded frame, data points into the decoder buffer until the callback returns
+ */
+typedef struct {
+    logger_export_event_t event;
+    int version;
+    int page_size;
+    int page_count;
+    int page_index;
+    int is_record;          /**< Page frames: records follow rather than text */
+    page_type_t type;       /**< Page type for page frames, level for records */
+    uint32_t timestamp;
+    const char *data;
+    int length;
+} logger_export_item_t;
+
+typedef void (*logger_export_fn)(void *ctx, const logger_export_item_t *item);
+
+/**
+ * @struct logger_decoder_t
+ * @brief Incremental export stream decoder, fed with bytes as they arrive
+ */
+typedef struct {
+    char *buffer;
+    int capacity;
+    logger_export_fn callback;
+    void *ctx;
+    uint8_t frame[5];
+    int have;
+    int need;
+    int version;
+    int page_index;
+    uint32_t timestamp;     /**< Previous record of the page, base of the next delta */
+    uint32_t crc;
+} logger_decoder_t;
+
+/**
+ * @brief Serializes every page into a compact, versioned binary stream
+ * @param logger Logger instance
+ * @param sink Destination, NULL for the logger's own sink
+ * @return Bytes written, -1 on error or when the sink reported a failure
+ * @note Only used bytes are sent, oldest page first and empty pages skipped. Records
+ *       get one length-prefixed frame each, deferred formats are rendered on the way
+ *       since their pointers mean nothing on the receiving side.
+ */
+int logger_export(LoggerHandler logger, const logger_sink_t *sink);
+
+/**
+ * @brief Exports the records of all shards as one stream merged by timestamp
+ * @note Page frames carry the shard index whenever the source shard changes.
+ */
+int logger_shards_export(LoggerShardsHandler shards, const logger_sink_t *sink);
+
+/**
+ * @brief Prepares a decoder for logger_decoder_feed()
+ * @param buffer Frame storage, at least LOGGER_EXPORT_CHUNK and the largest record; streams
+ *               with compressed pages need LOGGER_DECODER_ARCHIVE_SIZE() of their page size
+ * @param capacity Size of buffer
+ * @param callback Called once per decoded frame
+ * @note The callback of a LOGGER_EXPORT_HEADER item may point decoder->buffer and
+ *       decoder->capacity at a larger buffer sized from item->page_size.
+ */
+void logger_decoder_init(logger_decoder_t *decoder, char *buffer, int capacity,
+                         logger_export_fn callback, void *ctx);
+
+/**
+ * @brief Decodes the next bytes of an export stream, in pieces of any size
+ * @return 0 on success, -1 on a corrupt stream, checksum mismatch or a frame over capacity
+ * @note Several streams may follow each other; frames of unknown types are skipped.
+ */
+int logger_decoder_feed(logger_decoder_t *decoder, const char *data, int length);
+
 /**
  * @brief Sets the type/severity level of a page
  * @param logger Logger instance
@@ -111,15 +1065,192 @@ char *logger_get_page_buffer(LoggerHandler logger, int page_index);
  * @brief Clears a specific page, resetting it to empty
  * @param logger Logger instance
  * @param page_index Index of the page to clear
+ * @note Constant time: the write offset is reset and the page generation bumped, so
+ *       old records are no longer visible, but the old bytes stay in the buffer.
+ *       Use logger_set_secure_wipe() when flushed memory has to be zeroed.
  */
 void logger_flush_page(LoggerHandler logger, int page_index);
 
 /**
  * @brief Clears all pages in the logger
  * @param logger Logger instance
+ * @note Same constant time reset as logger_flush_page() for every page.
  */
 void logger_flush_all(LoggerHandler logger);
 
+/**
+ * @brief Makes every flush, rotations included, zero the whole page buffer
+ * @param logger Logger instance
+ * @param enable Non-zero to zero flushed pages, 0 for the constant time reset (default)
+ * @note Costs a memset of the page size per flush; use it when logged data must not
+ *       linger in memory, or when reading buffers from logger_get_page_buffer().
+ */
+void logger_set_secure_wipe(LoggerHandler logger, int enable);
+
+/**
+ * @brief Keeps pages compressed in a secondary pool before rotations overwrite them
+ * @param logger Logger instance
+ * @param pool_size Bytes of the pool, 0 turns compression off and frees the pool
+ * @return 0 on success, -1 on error
+ * @note Only pages a rotation reuses are compressed, on the producer that rotates
+ *       once it released the rotation lock; under the lock the page is only copied.
+ *       When the pool is full its oldest pages are dropped. The print functions show
+ *       archived pages before the live ones and logger_export() sends them, and the
+ *       live pages, compressed. The pool is heap memory, also for static arenas.
+ */
+int logger_set_compression(LoggerHandler logger, int pool_size);
+
+/**
+ * @struct logger_growth_t
+ * @brief Limits of dynamic page growth
+ */
+typedef struct {
+    int slab_pages;         /**< Pages added per growth step, allocated as one block */
+    size_t max_bytes;       /**< Hard cap on the memory of all added blocks */
+    int watermark;          /**< Grow once this few free pages are left ahead of the head, 0 waits until none is */
+} logger_growth_t;
+
+#define LOGGER_GROWTH_DEFAULT(max_bytes) { 4, (max_bytes), 0 }
+
+/**
+ * @brief Lets rotations add heap pages when the logger runs short, up to a hard cap
+ * @param logger Logger instance, not a mapped one
+ * @param growth Growth limits, NULL stops growing; added pages stay until logger_shrink() releases them
+ * @return 0 on success, -1 on error
+ * @note A rotation that finds no more than the watermark of free pages chains a block
+ *       of slab_pages pages in right after the head, so a linear logger no longer
+ *       stops at its last page and a drain logger no longer drops records while the
+ *       worker catches up. Ring loggers without a drain worker keep overwriting.
+ *       Added pages take the next page indices. The page table is reallocated here,
+ *       so do not call it while another thread reads the logger.
+ */
+int logger_set_growth(LoggerHandler logger, const logger_growth_t *growth);
+
+/**
+ * @brief Releases added pages that stayed idle since the previous call
+ * @param logger Logger instance
+ * @return Number of pages released, or -1 on error
+ * @note Call it periodically, e.g. from a one second timer. A block goes once none of
+ *       its pages held new data across two calls: empty pages, or pages the drain
+ *       worker already wrote out. Blocks are released newest first, so the indices of
+ *       the remaining pages never change. Do not print or export the logger from
+ *       another thread meanwhile, the released memory is freed.
+ */
+int logger_shrink(LoggerHandler logger);
+
+/**
+ * @brief Number of pages the logger holds right now, added pages included
+ * @return Page count, or -1 on error
+ */
+int logger_page_count(LoggerHandler logger);
+
+/**
+ * @brief Source of record timestamps, any monotonic 32-bit counter
+ * @note Called once per record, from interrupt handlers too when logger_isr_log() is used.
+ */
+typedef uint32_t (*logger_clock_fn)(void);
+
+/**
+ * @brief Microseconds from esp_timer or CLOCK_MONOTONIC, the default clock
+ */
+uint32_t logger_clock_us(void);
+
+/**
+ * @brief Microseconds at the resolution of the scheduler tick, from CLOCK_MONOTONIC_COARSE
+ * @note Same as logger_clock_us() where no coarse clock exists, e.g. on ESP-IDF.
+ */
+uint32_t logger_clock_coarse_us(void);
+
+/**
+ * @brief CPU cycle counter: esp_cpu_get_cycle_count() on Xtensa, the time stamp counter
+ *        on x86, the virtual counter on AArch64, nanoseconds elsewhere
+ * @note Wraps within seconds and counts per core; at 240 MHz the 32 bits last ~18 s.
+ */
+uint32_t logger_clock_cycles(void);
+
+/**
+ * @brief Sets where record timestamps come from
+ * @param clock Clock to use, NULL restores logger_clock_us()
+ * @note Timestamps, page summaries and logger_query() ranges are all in the units of
+ *       the clock. Set it before records are written and before other threads use the
+ *       logger; a clock change is not applied to records already stored.
+ */
+void logger_set_clock(LoggerHandler logger, logger_clock_fn clock);
+
+/**
+ * @struct logger_stats_t
+ * @brief Counters since creation or logger_reset_stats(), wrap at ULONG_MAX
+ */
+typedef struct {
+    unsigned long bytes_written;    /**< Page bytes filled, record headers and padding included */
+    unsigned long records;          /**< Records published */
+    unsigned long truncations;      /**< Text appends cut to the room left on their page */
+    unsigned long drops;            /**< Appends rejected because no page could take them */
+    unsigned long filtered;         /**< Records dropped by logger_set_level() */
+    unsigned long flushes;          /**< Page resets, by flush calls and rotations */
+    unsigned long rotations;        /**< Head page moves of logger_write() and friends */
+    unsigned long shed;             /**< Records dropped by logger_set_overflow() to keep room, counted in drops too */
+    unsigned long max_append_ns;    /**< Slowest sampled record append, text appends are not timed */
+} logger_stats_t;
+
+/**
+ * @brief Reads the statistics of a logger
+ * @param logger Logger instance
+ * @param stats Receives the counters
+ * @return 0 on success, -1 on error
+ * @note Counters are relaxed atomics, cheap enough to stay on in production; build
+ *       the library with LOGFLOW_STATS=0 to remove them. Append latency is timed on
+ *       one record out of 64. All zero when statistics are compiled out.
+ */
+int logger_get_stats(LoggerHandler logger, logger_stats_t *stats);
+
+/**
+ * @brief Highest fill level a page reached, in bytes, over all its generations
+ * @return The high-water mark or -1 if the page does not exist
+ */
+int logger_get_page_high_water(LoggerHandler logger, int page_index);
+
+/**
+ * @brief Zeroes the counters and the page high-water marks
+ */
+void logger_reset_stats(LoggerHandler logger);
+
+/**
+ * @struct logger_profile_path_t
+ * @brief Cycle timing of one path, in logger_clock_cycles() units
+ */
+typedef struct {
+    unsigned long calls;
+    unsigned long long cycles;      /**< Sum over all calls */
+    unsigned long max_cycles;       /**< Slowest call */
+} logger_profile_path_t;
+
+/**
+ * @struct logger_profile_t
+ * @brief Timing of the hot paths since start or logger_reset_profile()
+ */
+typedef struct {
+    logger_profile_path_t append;   /**< Record and text appends, rejected ones are not timed */
+    logger_profile_path_t flush;    /**< Page resets, by flush calls and rotations */
+    logger_profile_path_t print;    /**< Pages printed or exported, by print calls and the drain worker */
+    int enabled;                    /**< 1 when the library was built with LOGFLOW_PROFILE */
+} logger_profile_t;
+
+/**
+ * @brief Reads the cycle timing of the append, flush and print paths
+ * @param profile Receives the timing
+ * @return 0 on success, -1 on error
+ * @note Every call is timed, so this is meant for test and bench builds: configure with
+ *       -DLOGFLOW_PROFILE=ON to compile it in. All zero with enabled == 0 otherwise.
+ *       Timing is shared by every logger of the program.
+ */
+int logger_get_profile(logger_profile_t *profile);
+
+/**
+ * @brief Zeroes the cycle timing of logger_get_profile()
+ */
+void logger_reset_profile(void);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
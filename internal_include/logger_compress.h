@@ -0,0 +1,106 @@
+/**
+ * @file logger_compress.h
+ * @brief Page compression and the archive of compressed pages.
+ *
+ * The codec uses the LZ4 block layout: sequences of a token (literal and match
+ * length nibbles), literals, a 16-bit little-endian offset and extra length bytes,
+ * the last sequence holding only literals. Compression is greedy with one hash
+ * probe per position, tuned for the repetitive text of log pages rather than ratio.
+ *
+ * The archive keeps pages that a rotation is about to overwrite. Under the rotate
+ * lock the page is only copied into a staging slot; the rotating producer then
+ * serializes it into export frames, so deferred records are rendered and the result
+ * decodes without the producer's memory, and compresses it into a circular pool that
+ * drops its oldest entries when full, all after the lock is released.
+ */
+
+#pragma once
+
+#include "logger_internal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOGGER_LZ_HASH_BITS 10
+#define LOGGER_LZ_TABLE_SIZE (1 << LOGGER_LZ_HASH_BITS)
+
+// Worst case output, incompressible input grows by its literal length bytes
+#define LOGGER_LZ_BOUND(length) ((length) + (length) / 255 + 16)
+
+// Archive entry: [u32 compressed length][u32 raw length][compressed export frames]
+#define LOGGER_ARCHIVE_ENTRY_HEADER 8
+
+// Serialized pages bigger than this are cut at the limit, rendering may expand records
+#define LOGGER_ARCHIVE_RAW_SIZE(page_size) (2 * (page_size) + 64)
+
+/**
+ * @brief Compresses length bytes of src
+ * @param table LOGGER_LZ_TABLE_SIZE entries of scratch, no initialization needed
+ * @return Compressed size, -1 when capacity is below LOGGER_LZ_BOUND(length)
+ */
+int logger_lz_compress(const char *src, int length, char *dst, int capacity, uint32_t *table);
+
+/**
+ * @brief Decompresses a block from logger_lz_compress()
+ * @return Decompressed size, -1 on malformed input or when capacity is too small
+ */
+int logger_lz_decompress(const char *src, int length, char *dst, int capacity);
+
+/**
+ * @brief Serializes a page as export frames ('P' then 'T' or 'R' frames) into dst
+ * @return Bytes written, at most capacity; the last frame may be cut at the limit
+ */
+int logger_export_serialize(LoggerHandler logger, page_list *page, int index, char *dst, int capacity);
+
+/**
+ * @brief Feeds complete frames from memory to a decoder, ignoring a cut last frame
+ * @return 0 on success, -1 on a malformed frame
+ */
+int logger_decoder_frames(logger_decoder_t *decoder, const char *data, int length);
+
+/**
+ * @brief Copies a page into the staging slot of the archive before it is reset, caller holds the rotate lock
+ * @return Archive to pass to logger_archive_commit() once the lock is released, NULL when
+ *         compression is off or the page is empty
+ * @note One page is staged at a time, logger_archive_busy() tells when the slot is taken
+ */
+struct logger_archive *logger_archive_stage(LoggerHandler logger, page_list *page);
+
+/**
+ * @brief Compresses the staged page into the archive and frees the slot, without the rotate lock held
+ */
+void logger_archive_commit(LoggerHandler logger, struct logger_archive *archive);
+
+/**
+ * @brief Non-zero while the staged page is still being compressed, caller holds the rotate lock
+ */
+int logger_archive_busy(LoggerHandler logger);
+
+/**
+ * @brief Drops every archived page
+ */
+void logger_archive_clear(LoggerHandler logger);
+
+/**
+ * @brief Frees the archive, only once no producer can rotate any more
+ */
+void logger_archive_free(LoggerHandler logger);
+
+/**
+ * @brief Copies the archived entries, oldest first, into a buffer from mallocv()
+ * @param length Receives the size of the copy
+ * @return The copy, or NULL when nothing is archived; release it with freev()
+ * @note Each entry is a u32 compressed length, a u32 raw length and the compressed bytes.
+ */
+char *logger_archive_snapshot(LoggerHandler logger, int *length);
+
+/**
+ * @brief Prints archived pages, records filtered by level_mask and text by page type
+ * @param framed Non-zero wraps every page in "archived---[" "]---" like logger_print_all()
+ */
+void logger_archive_print(logger_out *out, LoggerHandler logger, uint32_t level_mask, int framed);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file logger_format.h
+ * @brief Deferred printf-style formatting for LogFlow records.
+ *
+ * Producers store the format string pointer plus the raw argument bytes instead of
+ * rendering text. The format string is parsed once to find the argument types, which
+ * is far cheaper than rendering them. Rendering happens later, when the record is
+ * printed or exported, by replaying every conversion through snprintf.
+ *
+ * Packed layout:
+ *   - const char *fmt            (native pointer, the format string must outlive the record)
+ *   - argument bytes in order    (native width of each promoted argument, unaligned)
+ *   - %s arguments are copied    (uint16_t length followed by the characters, no terminator)
+ *
+ * @note %n is not supported; packing fails on it.
+ */
+
+#pragma once
+
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Receives rendered text, possibly in several pieces.
+ */
+typedef void (*logger_emit_fn)(void *ctx, const char *data, int length);
+
+/**
+ * @brief Computes the packed size of a format string and its arguments.
+ * @return Number of bytes logger_format_pack() will write, or -1 on an unsupported format
+ */
+int logger_format_packed_size(const char *fmt, va_list args);
+
+/**
+ * @brief Packs the format pointer and arguments into out.
+ * @param out Destination, must hold logger_format_packed_size() bytes
+ * @return Number of bytes written
+ */
+int logger_format_pack(char *out, const char *fmt, va_list args);
+
+/**
+ * @brief Renders a packed record by replaying it through snprintf.
+ * @param packed Data written by logger_format_pack()
+ * @param length Size of the packed data
+ * @param emit Callback receiving the rendered text
+ * @param ctx Context passed to emit
+ */
+void logger_format_render(const char *packed, int length, logger_emit_fn emit, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,696 @@
+/**
+ * @file logger_internal.h
+ * @brief Private data structures of LogFlow shared by the library sources.
+ *
+ * Nothing in here is part of the public API; layouts may change between versions.
+ */
+
+#pragma once
+
+#include "logger.h"
+#include "genList.h"
+#include "logger_port.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+    #define ALIGNOF(type) _Alignof(type)
+#else
+    #define ALIGNOF(type) __alignof__(type)
+#endif
+
+// Set buffer alignment as required by your hardware (DMA, cache line, etc.)
+#define BUFFER_ALIGNMENT 8
+
+// Aligns pointer p up to the next multiple of align (align must be power of 2)
+#define ALIGN_PTR(p, align) ((uintptr_t)(((uintptr_t)(p) + ((align)-1)) & ~((uintptr_t)(align)-1)))
+
+// Content layout of a page, fixed by the first write after a flush
+typedef enum {
+    PAGE_FORMAT_EMPTY = 0,  // Nothing written yet
+    PAGE_FORMAT_TEXT,       // Plain text from logger_save_to_page*()
+    PAGE_FORMAT_RECORD      // Framed records from logger_append_atomic()
+} page_format_t;
+
+// --- Page summary ---
+// Kept up to date while records are reserved, so queries skip pages without reading
+// them. Timestamps are stored relative to the time the page was opened, which keeps
+// min and max plain unsigned comparisons across the 32-bit wrap of logger_now_us().
+// The origin sits LOGGER_SUMMARY_BACKDATE_US before the opening, so records stamped
+// earlier and merged later, such as those of logger_isr_log(), stay in order too.
+#ifndef LOGFLOW_INDEX
+#define LOGFLOW_INDEX 1
+#endif
+
+#define LOGGER_SUMMARY_BACKDATE_US (1u << 30) // ~18 minutes
+
+typedef struct page_summary {
+    uint32_t opened;            // logger_now_us() at the last reset - LOGGER_SUMMARY_BACKDATE_US
+    atomic_uint first;          // Earliest record timestamp - opened, UINT32_MAX while empty
+    atomic_uint last;           // Latest record timestamp - opened
+    atomic_uint tags;           // Bloom filter over record tag hashes
+    atomic_uint counts[LOGFLOW_LEVEL_NONE]; // Records reserved per LOGFLOW_LEVEL_* rank
+} page_summary;
+
+typedef struct page_list {
+    page_type_t type;
+    atomic_int used;        // Write offset, may overshoot the buffer size when a record page fills up
+    atomic_int sealed;      // End of the last record that fits once the page is closed, -1 while open
+    atomic_uchar format;    // page_format_t
+    atomic_uint epoch;      // Generation, bumped by every flush so stale records no longer match
+    int high_water;         // Highest fill level of earlier generations, for logger_get_page_high_water()
+    int foreign;            // Records before this offset were written by another image, see page_record_foreign()
+    page_summary summary;   // Levels, time span and tags of the records, see logger_query()
+    char *buffer;
+    struct list_head list;
+} page_list;
+
+// --- Record framing for concurrent appends ---
+// Each record is a header followed by its payload, padded to RECORD_ALIGNMENT.
+// Producers reserve a slot with a fetch-add on page->used, copy the payload and
+// then publish it by storing the commit tag of the page generation with release
+// semantics. Readers stop at the first record whose tag does not match the page,
+// so they never see a torn record, nor a stale one left over from before a flush.
+#define RECORD_ALIGNMENT 4
+#define RECORD_COMMIT_MARK 0x4C4F4746u // "LOGF"
+
+// Commit tag of a page generation, never 0 so zeroed memory never reads as committed
+#define RECORD_COMMIT_TAG(epoch) (RECORD_COMMIT_MARK ^ (uint32_t)(epoch))
+
+// What the payload of a record holds
+typedef enum {
+    RECORD_KIND_TEXT = 0,       // Raw text, printed as is
+    RECORD_KIND_DEFERRED,       // Format pointer plus packed arguments, rendered when printed
+    RECORD_KIND_PADDING,        // Abandoned reservation, skipped by readers
+    RECORD_KIND_TAGGED          // Text behind the registered tag of header->tag, printed as "tag: text"
+} record_kind_t;
+
+typedef struct record_header {
+    _Atomic uint32_t commit;    // RECORD_COMMIT_TAG() of the page once the payload is complete
+    uint16_t length;            // Payload length in bytes
+    uint16_t slot;              // Bytes taken by the record, header and padding included
+    uint8_t kind;               // record_kind_t
+    int8_t level;               // page_type_t of this record
+    uint16_t tag;               // logger_tag_hash() of the tag, 0 when untagged
+    uint32_t timestamp;         // logger_now_us() when the record was reserved
+} record_header;
+
+#define RECORD_SLOT_SIZE(length) \
+    (ALIGN_PTR(sizeof(record_header) + (length), RECORD_ALIGNMENT))
+
+#define RECORD_MAX_LENGTH (UINT16_MAX - sizeof(record_header) - RECORD_ALIGNMENT)
+
+// Logger behaviour flags
+#define LOGGER_FLAG_RING (1u << 0)  // logger_write() wraps around and overwrites the oldest page
+#define LOGGER_FLAG_SECURE_WIPE (1u << 1) // Flushes zero the whole buffer instead of a logical reset
+#define LOGGER_FLAG_STATIC (1u << 2) // Memory belongs to the caller, logger_destroy() does not free it
+#define LOGGER_FLAG_MAPPED (1u << 3) // Arena is a shared file mapping, see logger->map
+
+// Self-description stamped at the start of every arena. It lets logger_attach_existing()
+// re-adopt a region that survived a reset, e.g. RTC or no-init memory after a panic.
+#define LOGGER_PERSIST_MAGIC 0x5046474Cu // "LGFP"
+#define LOGGER_PERSIST_VERSION 2
+#define LOGGER_PERSIST_FLAGS LOGGER_FLAG_RING // Behaviour that survives a reset, the rest is runtime state
+
+typedef struct logger_persist {
+    uint32_t magic;             // LOGGER_PERSIST_MAGIC
+    uint16_t version;
+    uint16_t header_size;       // sizeof(struct logger_t), rejects arenas built by other versions
+    uint16_t entry_size;        // sizeof(page_list)
+    uint16_t layout;            // logger_layout_t
+    int32_t page_amount;
+    int32_t page_size;
+    int32_t buffer_alignment;
+    uint32_t flags;             // LOGGER_PERSIST_FLAGS bits
+    uint32_t image;             // Address of a constant of the program that stamped it, folded to 32 bits
+    uint64_t base;              // Address the arena was built at, saved pointers are relative to it
+    uint64_t alloc_size;
+    uint32_t crc;               // CRC-32 of every field above
+} logger_persist;
+
+// --- Statistics ---
+// Relaxed counters, gathered unless the library is built with LOGFLOW_STATS=0.
+// Only records cost an atomic add on the append path; written bytes come from the
+// page fill levels, summed when a page is reset and when the stats are read.
+// Append latency is sampled on one record out of LOGGER_STATS_SAMPLE_RATE.
+#ifndef LOGFLOW_STATS
+#define LOGFLOW_STATS 1
+#endif
+
+#ifndef LOGGER_STATS_SAMPLE_RATE
+#define LOGGER_STATS_SAMPLE_RATE 64 // Power of two
+#endif
+
+typedef struct logger_stats_block {
+    atomic_ulong bytes;
+    atomic_ulong records;
+    atomic_ulong truncations;
+    atomic_ulong drops;
+    atomic_ulong filtered;
+    atomic_ulong flushes;
+    atomic_ulong rotations;
+    atomic_ulong shed;
+    atomic_ulong max_append_ns;
+} logger_stats_block;
+
+struct logger_t {
+    logger_persist persist;         // Must stay first, found at the start of the region on attach
+    int page_buffer_size;
+    int total_pages;
+    uint32_t flags;
+    logger_layout_t layout;         // Where the page_list entries live relative to the buffers
+    int buffer_alignment;           // Every buffer starts at a multiple of this
+    size_t alloc_size;              // Bytes of the whole arena, this struct included
+    page_list **page_table;         // Indexed view of the pages, page_table[i] is page i
+    _Atomic(page_list *) head;      // Page logger_write() appends to
+    atomic_flag rotate_lock;        // Serializes head rotation, never taken on the append fast path
+    logger_sink_t sink;             // Destination of the print functions
+    struct logger_drain *drain;     // Background drain worker, NULL when not started
+    _Atomic(page_list *) tail;      // Oldest full page waiting for the drain worker, == head when none
+    page_list *draining;            // Page the drain worker is writing out, never overwritten
+    atomic_int pending;             // Full pages between tail and head
+    logger_map_t map;               // Backing file of a mapped logger
+    struct logger_archive *archive; // Compressed pages from logger_set_compression(), NULL when off
+    struct logger_pool *pool;       // Extra pages from logger_set_growth(), NULL when off
+    struct logger_isr *isr;         // Rings of logger_isr_log(), NULL until logger_isr_enable()
+    logger_clock_fn clock;          // Record timestamps, logger_clock_us() unless logger_set_clock()
+    atomic_int min_rank;            // LOGFLOW_LEVEL_* below which records are dropped
+    int overflow_depth;             // Largest entry of overflow_floor, 0 when logger_set_overflow() is off
+    int overflow_floor[LOGFLOW_LEVEL_NONE]; // Free pages a rank must leave for higher ones, rotate lock
+    page_list pages;                // List head, kept for ordered iteration
+    char stats_gap[LOGGER_CACHE_LINE_SIZE]; // Keeps the contended counters off the lines above
+    logger_stats_block stats;
+};
+
+// --- Alignment-aware block size calculation ---
+#define LOGGER_SIZE_BASE (sizeof(struct logger_t))
+
+// Page table placed right after logger_t: one pointer per page
+#define LOGGER_TABLE_SIZE(pages) \
+    (ALIGN_PTR((pages) * sizeof(page_list *), ALIGNOF(page_list)))
+
+// Each block: aligned page_list + aligned buffer (with padding)
+#define LOGGER_BLOCK_SIZE(page_size) \
+    (ALIGN_PTR(sizeof(page_list), ALIGNOF(page_list)) \
+    + ALIGN_PTR(page_size, BUFFER_ALIGNMENT))
+
+// Total allocation size
+#define LOGGER_ALLOC_SIZE(pages, size) \
+    (LOGGER_SIZE_BASE + LOGGER_TABLE_SIZE(pages) + (pages) * LOGGER_BLOCK_SIZE(size) + BUFFER_ALIGNMENT)
+
+// LOGGER_LAYOUT_SPLIT: one page_list per cache line, then the buffers
+#define LOGGER_META_STRIDE ALIGN_PTR(sizeof(page_list), LOGGER_CACHE_LINE_SIZE)
+
+// Bytes of the buffer holding data, clamped since record reservations may overshoot
+static inline int page_used(LoggerHandler logger, page_list *page)
+{
+    int used = atomic_load_explicit(&page->used, memory_order_acquire);
+    return used < logger->page_buffer_size ? used : logger->page_buffer_size;
+}
+
+static inline int page_remaining(LoggerHandler logger, page_list *page)
+{
+    return logger->page_buffer_size - page_used(logger, page);
+}
+
+// Claims an empty page for the given format, fails if it already holds the other one
+static inline int page_claim_format(page_list *page, page_format_t format)
+{
+    unsigned char current = atomic_load_explicit(&page->format, memory_order_acquire);
+    if (current == PAGE_FORMAT_EMPTY) {
+        unsigned char expected = PAGE_FORMAT_EMPTY;
+        if (atomic_compare_exchange_strong(&page->format, &expected, format)) {
+            return 0;
+        }
+        current = expected;
+    }
+    return current == format ? 0 : -1;
+}
+
+static inline uint32_t page_commit_tag(page_list *page)
+{
+    return RECORD_COMMIT_TAG(atomic_load_explicit(&page->epoch, memory_order_relaxed));
+}
+
+// Walks committed records of a page, returns the next one after *offset or NULL
+static inline const record_header *page_next_record(LoggerHandler logger, page_list *page, int *offset)
+{
+    const int limit = page_used(logger, page);
+    const uint32_t tag = page_commit_tag(page);
+    while (*offset + (int)sizeof(record_header) <= limit) {
+        const record_header *header = (const record_header *)(page->buffer + *offset);
+        if (atomic_load_explicit(&header->commit, memory_order_acquire) != tag) {
+            return NULL; // Not published yet, everything after it is invisible too
+        }
+        *offset += header->slot;
+        if (header->kind != RECORD_KIND_PADDING) {
+            return header;
+        }
+    }
+    return NULL;
+}
+
+#define RECORD_DATA(header) ((const char *)((header) + 1))
+
+static inline int record_matches(const record_header *record, uint32_t level_mask)
+{
+    return (level_mask & LOGGER_LEVEL_MASK(record->level)) != 0;
+}
+
+// Deferred records adopted from another program point at formats that are not in this one
+static inline int page_record_foreign(const page_list *page, const record_header *record)
+{
+    return (const char *)record - page->buffer < page->foreign;
+}
+
+// Timestamps wrap, so order them by their signed distance
+static inline int record_before(const record_header *a, const record_header *b)
+{
+    return (int32_t)(a->timestamp - b->timestamp) < 0;
+}
+
+// Next page in list order, wrapping over the list head
+static inline page_list *page_next(LoggerHandler logger, page_list *page)
+{
+    struct list_head *next = page->list.next;
+    if (next == &logger->pages.list) {
+        next = next->next;
+    }
+    return list_entry(next, page_list, list);
+}
+
+// First page in chronological order, ring loggers start right after the head page
+static inline page_list *logger_oldest_page(LoggerHandler logger)
+{
+    if (logger->flags & LOGGER_FLAG_RING) {
+        return page_next(logger, atomic_load_explicit(&logger->head, memory_order_acquire));
+    }
+    return logger->page_table[0];
+}
+
+// --- Constant-time page lookup, NULL if the index is out of range ---
+static inline page_list *logger_get_page(LoggerHandler logger, int index)
+{
+    if (logger == NULL || index < 0 || index >= logger->total_pages) {
+        return NULL;
+    }
+    return logger->page_table[index];
+}
+
+// Index of a page, -1 if it is not part of the logger
+static inline int logger_page_index(LoggerHandler logger, const page_list *page)
+{
+    for (int i = 0; i < logger->total_pages; i++) {
+        if (logger->page_table[i] == page) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// --- Head rotation, shared with the drain worker ---
+static inline void logger_rotate_lock(LoggerHandler logger)
+{
+    while (atomic_flag_test_and_set_explicit(&logger->rotate_lock, memory_order_acquire)) {
+        logger_spin_pause();
+    }
+}
+
+static inline void logger_rotate_unlock(LoggerHandler logger)
+{
+    atomic_flag_clear_explicit(&logger->rotate_lock, memory_order_release);
+}
+
+/**
+ * @brief CRC-32 (IEEE, reflected), pass 0 to start and the previous result to continue
+ */
+uint32_t logger_crc32(uint32_t crc, const void *data, size_t length);
+
+/**
+ * @brief Checks that a persistent header is intact and describes an arena fitting in len bytes
+ * @return 0 when valid, -1 otherwise
+ */
+int logger_persist_check(const logger_persist *persist, size_t len);
+
+/**
+ * @brief Address of the page_list entry and buffer of page index in an arena starting at base
+ * @note Only reads the geometry fields of persist, so readers mapping the arena elsewhere
+ *       (another process, a file) locate pages exactly like the logger that built it.
+ */
+void logger_layout_page(const logger_persist *persist, uintptr_t base, int index,
+                        uintptr_t *entry, uintptr_t *buffer);
+
+/**
+ * @brief Bytes taken by page_amount pages laid out from an arbitrary start, alignment slack included
+ */
+size_t logger_pages_size(int page_amount, int page_size, logger_layout_t layout, size_t align);
+
+/**
+ * @brief Bytes of a whole logger built in place: logger_t, page table and pages
+ */
+size_t logger_arena_size(int page_amount, int page_size, logger_layout_t layout, size_t align);
+
+/**
+ * @brief Builds a logger in memory of length bytes, any alignment, or on the heap when memory is NULL
+ */
+LoggerHandler logger_create_in(const logger_config_t *config, void *memory, size_t length);
+
+/**
+ * @brief Address of the page_list entry and buffer of page index in pages laid out from memory
+ * @note Uses the geometry fields of persist, logger_layout_page() calls it for the arena.
+ */
+void logger_layout_pages(const logger_persist *persist, uintptr_t memory, int index,
+                         uintptr_t *entry, uintptr_t *buffer);
+
+/**
+ * @brief Sets up an empty page over a zeroed buffer, not linked into any list yet
+ */
+void page_init_empty(LoggerHandler logger, page_list *page, char *buffer);
+
+/**
+ * @brief Moves the head past full, unless another producer already did
+ * @param level Level of the record that needs the room, checked against logger_set_overflow()
+ * @return 0 once the head moved, -1 when no page can take over
+ */
+int logger_rotate(LoggerHandler logger, page_list *full, page_type_t level);
+
+/**
+ * @brief Free pages ahead of full, counted up to limit + 1; caller holds the rotate lock
+ * @note Ring loggers without a drain worker overwrite their oldest page and are never short.
+ */
+int logger_free_pages(LoggerHandler logger, page_list *full, int limit);
+
+/**
+ * @brief Waits until every record reserved on a closed page has been committed
+ */
+void page_wait_settled(page_list *page);
+
+// Tells the drain worker a page filled up, it wakes once the high watermark is reached
+void logger_drain_notify(LoggerHandler logger, int pending);
+
+// Wakes the drain worker from an interrupt handler, no-op without a worker
+void logger_drain_notify_isr(LoggerHandler logger);
+
+/**
+ * @brief Starts a drain worker for up to capacity loggers, none attached yet
+ * @param shared Non-zero keeps it running when logger_drain_stop() detaches its members
+ * @return The worker, NULL when it could not be started
+ */
+struct logger_drain *logger_drain_open(const logger_drain_config_t *config, int capacity, int shared);
+
+/**
+ * @brief Hands the full pages of logger to drain from now on
+ * @return 0 on success, -1 when the worker is full or the logger cannot be drained
+ */
+int logger_drain_attach(struct logger_drain *drain, LoggerHandler logger);
+
+/**
+ * @brief Stops the worker after writing out what its members still queued, then detaches them
+ */
+void logger_drain_close(struct logger_drain *drain);
+
+/**
+ * @brief logger_log() with a timestamp taken earlier, used to merge records logged elsewhere
+ * @return Bytes stored, -1 when no page could take the record
+ */
+int logger_log_at(LoggerHandler logger, page_type_t level, uint32_t timestamp, const char *data, int size);
+
+/**
+ * @brief Frees the rings of logger_isr_enable(), once no interrupt handler can log any more
+ */
+void logger_isr_free(LoggerHandler logger);
+
+// --- Batched output ---
+// Print paths stage small pieces (headers, rendered records) and hand the sink
+// large contiguous spans, such as the text of a page, in a single call.
+#ifndef LOGGER_OUT_BUFFER_SIZE
+#define LOGGER_OUT_BUFFER_SIZE 256
+#endif
+
+typedef struct logger_out {
+    const logger_sink_t *sink;
+    int length;
+    char buffer[LOGGER_OUT_BUFFER_SIZE];
+} logger_out;
+
+static inline void logger_out_init(logger_out *out, LoggerHandler logger)
+{
+    out->sink = &logger->sink;
+    out->length = 0;
+}
+
+void logger_out_flush(logger_out *out);
+void logger_out_end(logger_out *out); // Flushes and tells the sink the output is complete
+void logger_out_write(logger_out *out, const char *data, int length);
+void logger_out_printf(logger_out *out, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+void logger_out_emit(void *ctx, const char *data, int length); // logger_emit_fn adapter, ctx is a logger_out
+
+static inline void logger_out_puts(logger_out *out, const char *s)
+{
+    logger_out_write(out, s, (int)strlen(s));
+}
+
+#define LOGGER_EXPORT_VERSION 2     // Layout of the frames this build writes
+
+/**
+ * @brief Writes one page as a header frame followed by its 'P' and 'T' or 'R' frames
+ * @note Every page repeats the header, so a receiver can join the stream at any page.
+ */
+void logger_export_stream_page(logger_out *out, LoggerHandler logger, page_list *page);
+
+// What a decoder knows after the frames it read so far, enough to resume mid-page:
+// record timestamps are deltas, so a receiver that lost the frames before needs it
+typedef struct {
+    uint16_t version;           // 0 until a header frame went by
+    uint8_t format;             // page_format_t of the current page, PAGE_FORMAT_EMPTY outside one
+    int8_t type;
+    uint32_t page_index;
+    uint32_t timestamp;         // Last record of the page, base of the next delta
+} logger_export_context;
+
+#define LOGGER_EXPORT_CONTEXT_SIZE 17 // Bytes of a 'C' frame, header included
+
+/**
+ * @brief Advances a context over one whole frame, header included
+ */
+void logger_export_context_track(logger_export_context *context, const char *frame, int length);
+
+/**
+ * @brief Writes the 'C' frame restoring a context, decoders do not checksum it
+ * @return LOGGER_EXPORT_CONTEXT_SIZE, or 0 when no header went by yet
+ */
+int logger_export_context_frame(const logger_export_context *context, char *out);
+
+/**
+ * @brief Writes the content of a page, records rendered one per line or raw text
+ */
+void logger_print_content(logger_out *out, LoggerHandler logger, page_list *page);
+
+#if LOGFLOW_STATS
+#define LOGGER_STAT_ADD(logger, field, n) \
+    atomic_fetch_add_explicit(&(logger)->stats.field, (unsigned long)(n), memory_order_relaxed)
+
+// Start of a sampled append, 0 when this append is not timed
+static inline uint32_t logger_stat_begin(LoggerHandler logger)
+{
+    unsigned long n = atomic_load_explicit(&logger->stats.records, memory_order_relaxed);
+    return (n & (LOGGER_STATS_SAMPLE_RATE - 1)) == 0 ? (logger_now_ns() | 1u) : 0;
+}
+
+static inline void logger_stat_end(LoggerHandler logger, uint32_t start)
+{
+    if (start == 0) {
+        return;
+    }
+    unsigned long elapsed = logger_now_ns() - start;
+    unsigned long max = atomic_load_explicit(&logger->stats.max_append_ns, memory_order_relaxed);
+    while (elapsed > max
+           && !atomic_compare_exchange_weak_explicit(&logger->stats.max_append_ns, &max, elapsed,
+                                                     memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+#else
+#define LOGGER_STAT_ADD(logger, field, n) ((void)0)
+static inline uint32_t logger_stat_begin(LoggerHandler logger) { (void)logger; return 0; }
+static inline void logger_stat_end(LoggerHandler logger, uint32_t start) { (void)logger; (void)start; }
+#endif
+
+// --- Profiling ---
+// Cycle timing of every append, page flush and page print, compiled in by building
+// with LOGFLOW_PROFILE=1 (the LOGFLOW_PROFILE CMake option). Unlike the statistics
+// nothing is sampled, so this is for test and bench builds, not for the fleet.
+#ifndef LOGFLOW_PROFILE
+#define LOGFLOW_PROFILE 0
+#endif
+
+typedef enum {
+    LOGGER_PROFILE_APPEND,
+    LOGGER_PROFILE_FLUSH,
+    LOGGER_PROFILE_PRINT,
+    LOGGER_PROFILE_PATHS
+} logger_profile_path;
+
+#if LOGFLOW_PROFILE
+void logger_profile_add(logger_profile_path path, uint32_t cycles);
+
+static inline uint32_t logger_profile_begin(void)
+{
+    return logger_clock_cycles();
+}
+
+static inline void logger_profile_end(logger_profile_path path, uint32_t start)
+{
+    logger_profile_add(path, logger_clock_cycles() - start);
+}
+#else
+static inline uint32_t logger_profile_begin(void) { return 0; }
+static inline void logger_profile_end(logger_profile_path path, uint32_t start) { (void)path; (void)start; }
+#endif
+
+// 16-bit FNV-1a of a tag string, never 0 so untagged records never match
+static inline uint16_t logger_tag_hash(const char *tag)
+{
+    uint32_t hash = 2166136261u;
+    for (; *tag != '\0'; tag++) {
+        hash = (hash ^ (unsigned char)*tag) * 16777619u;
+    }
+    hash = (hash >> 16) ^ (hash & 0xFFFFu);
+    return hash != 0 ? (uint16_t)hash : 1;
+}
+
+// Two bits of the 32-bit page bloom filter
+static inline uint32_t logger_tag_bloom(uint16_t hash)
+{
+    return (1u << (hash & 31)) | (1u << ((hash >> 5) & 31));
+}
+
+#define LOGGER_TAG_UNKNOWN_SIZE 8   // "#hhhh" stand-in for a tag this program never registered
+
+/**
+ * @brief Registered tag of a hash, NULL when there is none
+ * @param length Set to the tag length when found, may be NULL
+ */
+const char *logger_tag_lookup(uint16_t hash, int *length);
+
+/**
+ * @brief Text of the tag of a RECORD_KIND_TAGGED record
+ * @param unknown LOGGER_TAG_UNKNOWN_SIZE bytes, holds the stand-in of an unregistered hash
+ * @return Length of *text, which is not null-terminated
+ */
+int logger_tag_text(uint16_t hash, char *unknown, const char **text);
+
+static inline void page_summary_reset(page_list *page, uint32_t opened)
+{
+    page_summary *summary = &page->summary;
+    summary->opened = opened - LOGGER_SUMMARY_BACKDATE_US;
+    atomic_store_explicit(&summary->first, UINT32_MAX, memory_order_relaxed);
+    atomic_store_explicit(&summary->last, 0, memory_order_relaxed);
+    atomic_store_explicit(&summary->tags, 0, memory_order_relaxed);
+    for (int i = 0; i < LOGFLOW_LEVEL_NONE; i++) {
+        atomic_store_explicit(&summary->counts[i], 0, memory_order_relaxed);
+    }
+}
+
+#if LOGFLOW_INDEX
+// One add per record; the span only moves with a CAS when the record extends it
+static inline void page_summary_add(page_list *page, page_type_t level, uint32_t timestamp)
+{
+    page_summary *summary = &page->summary;
+    const uint32_t delta = timestamp - summary->opened;
+    atomic_fetch_add_explicit(&summary->counts[LOGFLOW_LEVEL_RANK(level)], 1, memory_order_relaxed);
+    unsigned int last = atomic_load_explicit(&summary->last, memory_order_relaxed);
+    while (delta > last
+           && !atomic_compare_exchange_weak_explicit(&summary->last, &last, delta,
+                                                     memory_order_relaxed, memory_order_relaxed)) {
+    }
+    unsigned int first = atomic_load_explicit(&summary->first, memory_order_relaxed);
+    while (delta < first
+           && !atomic_compare_exchange_weak_explicit(&summary->first, &first, delta,
+                                                     memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static inline void page_summary_tag(page_list *page, uint16_t hash)
+{
+    const uint32_t bits = logger_tag_bloom(hash);
+    if ((atomic_load_explicit(&page->summary.tags, memory_order_relaxed) & bits) != bits) {
+        atomic_fetch_or_explicit(&page->summary.tags, bits, memory_order_relaxed);
+    }
+}
+#else
+static inline void page_summary_add(page_list *page, page_type_t level, uint32_t timestamp)
+{
+    (void)page; (void)level; (void)timestamp;
+}
+static inline void page_summary_tag(page_list *page, uint16_t hash) { (void)page; (void)hash; }
+#endif
+
+// Length of a fragment, a length of 0 or less stands for strlen(base)
+static inline int iov_length(const struct logger_iov *iov)
+{
+    return iov->length > 0 ? iov->length : (int)strlen(iov->base);
+}
+
+// Bytes a page holds: the sealed end of a closed record page, the write offset otherwise
+static inline int page_fill(LoggerHandler logger, page_list *page)
+{
+    int used = atomic_load_explicit(&page->sealed, memory_order_relaxed);
+    if (used < 0) {
+        used = atomic_load_explicit(&page->used, memory_order_relaxed);
+    }
+    return used > logger->page_buffer_size ? logger->page_buffer_size : used;
+}
+
+// Run time threshold of logger_set_level(), one relaxed load on the append path
+static inline int logger_level_passes(LoggerHandler logger, page_type_t level)
+{
+    return LOGFLOW_LEVEL_RANK(level) >= atomic_load_explicit(&logger->min_rank, memory_order_relaxed);
+}
+
+/**
+ * @brief Level prefix printed in front of records and filtered text pages, e.g. "error: "
+ */
+const char *logger_print_start_message_section(page_type_t type);
+
+/**
+ * @brief Renders the format of a deferred record on page, a placeholder when page_record_foreign()
+ */
+void logger_record_render(const page_list *page, const record_header *record,
+                          void (*emit)(void *ctx, const char *data, int length), void *ctx);
+
+/**
+ * @brief Writes one record of page as "[timestamp] level: payload", without a line break
+ */
+void logger_print_record(logger_out *out, const page_list *page, const record_header *record);
+
+/**
+ * @brief Text of a record of page, deferred and tagged records rendered into rendered (LOGGER_LINE_RENDER_SIZE bytes)
+ * @return Length of *text
+ */
+int logger_record_text(const page_list *page, const record_header *record, char *rendered, const char **text);
+
+#ifndef LOGGER_LINE_RENDER_SIZE
+#define LOGGER_LINE_RENDER_SIZE 256 // Deferred records are rendered into this much stack
+#endif
+
+/**
+ * @brief Bytes of text held by a page, its write offset or the string length for raw buffers
+ */
+int page_text_length(LoggerHandler logger, page_list *page);
+
+/**
+ * @brief Calls emit for every record of every shard matching level_mask, oldest first
+ */
+void logger_shards_merge(LoggerShardsHandler shards, uint32_t level_mask,
+                         void (*emit)(void *ctx, int shard, const page_list *page, const record_header *record),
+                         void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file logger_pool.h
+ * @brief Extra pages chained onto a logger under burst load.
+ *
+ * Growth adds slabs: one allocation holding a few pages laid out like the arena.
+ * A rotation that runs short of free pages splices a new slab right after the
+ * full head page, so the new pages are written next and chronological order
+ * along the list is kept. Slabs are released newest first, which keeps the
+ * index of every remaining page stable.
+ *
+ * The members of a logger group take their slabs from one shared region instead,
+ * so pages a quiet logger gave back can be lent to a busy one.
+ */
+
+#pragma once
+
+#include "logger_internal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Adds a slab after full when no more than the watermark of free pages is left
+ * @return 0 when pages were added, -1 otherwise; caller holds the rotate lock
+ * @note Ring loggers without a drain worker overwrite by design and never grow.
+ */
+int logger_pool_grow(LoggerHandler logger, page_list *full);
+
+/**
+ * @brief Frees every slab and the grown page table, only once no producer can rotate any more
+ */
+void logger_pool_free(LoggerHandler logger);
+
+/**
+ * @brief Bytes of a slab of count pages laid out like the arena, slab bookkeeping included
+ */
+size_t logger_pool_slab_size(int count, int page_size, logger_layout_t layout, size_t align);
+
+struct logger_group_t;
+
+/**
+ * @brief Lets logger grow by up to slabs slabs of slab_pages pages, borrowed from group
+ * @return 0 on success, -1 when out of memory
+ */
+int logger_pool_share(LoggerHandler logger, struct logger_group_t *group, int slab_pages, int slabs);
+
+/**
+ * @brief A free slab of the group's shared region, NULL once all are lent out
+ * @note Called with the rotate lock of the borrowing logger held.
+ */
+void *logger_group_take(struct logger_group_t *group);
+
+/**
+ * @brief Returns a slab of logger_group_take() to the shared region
+ */
+void logger_group_give(struct logger_group_t *group, void *slab);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,162 @@
+/**
+ * @file logger_port.h
+ * @brief Platform shims used by LogFlow: memory, clock, threads, semaphores and sockets.
+ *
+ * ESP-IDF builds (__XTENSA__) map onto heap_caps, esp_timer and FreeRTOS tasks;
+ * every other target uses the C library and POSIX threads.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__XTENSA__)
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#else
+#include <pthread.h>
+#include <semaphore.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Code an interrupt handler may reach: kept in IRAM on ESP-IDF, so it also runs
+// while the flash cache is disabled
+#if defined(__XTENSA__)
+#define LOGGER_ISR_ATTR IRAM_ATTR
+#else
+#define LOGGER_ISR_ATTR
+#endif
+
+// --- Memory ---
+void *mallocv(int size);
+void freev(void *object);
+
+// --- Clock ---
+
+/**
+ * @brief Monotonic clock in microseconds, wraps after ~71 minutes
+ * @note Safe in interrupt handlers and POSIX signal handlers.
+ */
+uint32_t logger_now_us(void);
+
+/**
+ * @brief Monotonic clock in nanoseconds for short intervals, wraps after ~4 seconds
+ * @note Microsecond resolution on ESP-IDF.
+ */
+uint32_t logger_now_ns(void);
+
+static inline void logger_spin_pause(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// --- Threads ---
+#if defined(__XTENSA__)
+typedef struct {
+    TaskHandle_t task;
+    SemaphoreHandle_t done;     // Given by the task right before it deletes itself
+} logger_thread_t;
+typedef SemaphoreHandle_t logger_sem_t;
+#else
+typedef pthread_t logger_thread_t;
+typedef sem_t logger_sem_t;
+#endif
+
+/**
+ * @brief Starts a thread (FreeRTOS task on ESP-IDF)
+ * @param stack_size Stack size in bytes, ignored on POSIX
+ * @param priority Task priority, ignored on POSIX
+ * @return 0 on success, -1 on error
+ */
+int logger_thread_start(logger_thread_t *thread, void (*entry)(void *), void *arg,
+                        const char *name, int stack_size, int priority);
+
+/**
+ * @brief Waits for a thread started with logger_thread_start() to return
+ */
+void logger_thread_join(logger_thread_t *thread);
+
+void logger_sleep_ms(int ms);
+
+/**
+ * @brief Small number that stays the same for the calling thread
+ * @return The core id on ESP-IDF, a per-thread counter handed out on first use elsewhere
+ * @note Safe in interrupt handlers, where it returns the core taking the interrupt.
+ */
+int logger_thread_slot(void);
+
+// --- File mappings, host builds only ---
+typedef struct {
+    int fd;
+    void *addr;
+    size_t length;
+} logger_map_t;
+
+/**
+ * @brief Opens or creates path and maps it shared, read-write
+ * @param length Size to map, the file is grown or shrunk to it; 0 maps the file at its current size
+ * @return 0 on success, -1 on error or on targets without mmap
+ */
+int logger_map_open(logger_map_t *map, const char *path, size_t length);
+
+/**
+ * @brief Starts writing back [addr, addr + length) without waiting for it
+ */
+void logger_map_sync_async(logger_map_t *map, const void *addr, size_t length);
+
+/**
+ * @brief Writes everything back, unmaps and closes the file
+ */
+void logger_map_close(logger_map_t *map);
+
+// --- Sockets ---
+
+/**
+ * @brief Opens a non-blocking UDP or TCP socket connected to host:port
+ * @param stream Non-zero for TCP
+ * @return Socket descriptor, -1 when the name does not resolve or no connection is made
+ * @note The TCP connect itself blocks until it succeeds or fails.
+ */
+int logger_socket_open(const char *host, int port, int stream);
+
+/**
+ * @brief Sends up to length bytes, a whole datagram on UDP sockets
+ * @param timeout_ms Longest wait for room in the socket buffer, 0 never waits, negative waits forever
+ * @return Bytes sent, 0 when the socket stayed full, -1 on error
+ */
+int logger_socket_send(int fd, const void *data, int length, int timeout_ms);
+
+void logger_socket_close(int fd);
+
+// --- Counting semaphores ---
+int logger_sem_init(logger_sem_t *sem);
+void logger_sem_destroy(logger_sem_t *sem);
+
+/**
+ * @brief Signals the semaphore, never blocks
+ */
+void logger_sem_post(logger_sem_t *sem);
+
+/**
+ * @brief logger_sem_post() for interrupt handlers, and for signal handlers on POSIX
+ */
+void logger_sem_post_isr(logger_sem_t *sem);
+
+/**
+ * @brief Waits for the semaphore
+ * @param timeout_ms Maximum wait, negative waits forever
+ * @return 0 when signalled, -1 on timeout
+ */
+int logger_sem_wait(logger_sem_t *sem, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
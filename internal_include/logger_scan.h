@@ -0,0 +1,28 @@
+/**
+ * @file logger_scan.h
+ * @brief Vectorized byte scanning for page readers.
+ *
+ * SSE2 on x86, NEON on AArch64, a scalar fallback everywhere else (Xtensa
+ * included). Both helpers compare 16 bytes per step and only branch once per
+ * block, so large text pages are split at memory bandwidth.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief First occurrence of c in [data, data + length), NULL if none
+ */
+const char *logger_scan_byte(const char *data, int length, char c);
+
+/**
+ * @brief Number of occurrences of c in [data, data + length)
+ */
+int logger_count_byte(const char *data, int length, char c);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,113 +1,249 @@
 #include "logger.h"
-#include "genList.h"
+#include "logger_internal.h"
+#include "logger_format.h"
+#include "logger_compress.h"
+#include "logger_pool.h"
+#include "logger_scan.h"
+#include "logger_port.h"
 #include <stdint.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
 #include <stdlib.h>
 
-#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
-    #define ALIGNOF(type) _Alignof(type)
-#else
-    #define ALIGNOF(type) __alignof__(type)
-#endif
+// --- List manipulation helpers (assume Linux-style list_head) ---
+static void logger_page_add(page_list *main, page_list *page) 
+{
+    list_add_tail(&page->list, &main->list);
+}
+
+// --- Arena layout ---
+// Inline: [logger_t][table][page_list|buffer][page_list|buffer]...
+// Split:  [logger_t][table][page_list, padded to a cache line]...[buffer][buffer]...
+static size_t logger_block_size(int page_size, size_t align)
+{
+    return ALIGN_PTR(sizeof(page_list), align) + ALIGN_PTR(page_size, align);
+}
 
-// Set buffer alignment as required by your hardware (DMA, cache line, etc.)
-#define BUFFER_ALIGNMENT 8
+size_t logger_pages_size(int page_amount, int page_size, logger_layout_t layout, size_t align)
+{
+    if (layout == LOGGER_LAYOUT_SPLIT) {
+        const size_t line = LOGGER_CACHE_LINE_SIZE;
+        const size_t buffers_align = align > line ? align : line;
+        return line + page_amount * LOGGER_META_STRIDE + buffers_align + page_amount * ALIGN_PTR(page_size, align);
+    }
+    return page_amount * logger_block_size(page_size, align) + align; // Same as LOGGER_ALLOC_SIZE for 8 bytes
+}
 
-// Aligns pointer p up to the next multiple of align (align must be power of 2)
-#define ALIGN_PTR(p, align) ((uintptr_t)(((uintptr_t)(p) + ((align)-1)) & ~((uintptr_t)(align)-1)))
+size_t logger_arena_size(int page_amount, int page_size, logger_layout_t layout, size_t align)
+{
+    return LOGGER_SIZE_BASE + LOGGER_TABLE_SIZE(page_amount) + logger_pages_size(page_amount, page_size, layout, align);
+}
 
-// Platform-specific malloc/free
-#if defined(__XTENSA__)
-#include "esp_system.h"
-#include "esp_heap_caps.h"
+void logger_layout_pages(const logger_persist *persist, uintptr_t memory, int index,
+                         uintptr_t *entry, uintptr_t *buffer)
+{
+    const int page_amount = persist->page_amount;
+    const int page_size = persist->page_size;
+    const size_t align = persist->buffer_alignment;
 
-void *mallocv(int size) 
-{ 
-    return heap_caps_malloc(size, MALLOC_CAP_8BIT | MALLOC_CAP_DMA); 
+    if (persist->layout == LOGGER_LAYOUT_SPLIT) {
+        const size_t line = LOGGER_CACHE_LINE_SIZE;
+        const uintptr_t entry_base = ALIGN_PTR(memory, line);
+        const uintptr_t buffer_base = ALIGN_PTR(entry_base + page_amount * LOGGER_META_STRIDE, align > line ? align : line);
+        *entry = entry_base + index * LOGGER_META_STRIDE;
+        *buffer = buffer_base + index * ALIGN_PTR(page_size, align);
+    }
+    else {
+        const uintptr_t entry_base = ALIGN_PTR(memory, align);
+        *entry = entry_base + index * logger_block_size(page_size, align);
+        *buffer = *entry + ALIGN_PTR(sizeof(page_list), align);
+    }
 }
 
-void freev(void *object) 
-{ 
-    heap_caps_free(object); 
+void logger_layout_page(const logger_persist *persist, uintptr_t base, int index,
+                        uintptr_t *entry, uintptr_t *buffer)
+{
+    // Pages start right after logger_t and the page table
+    const uintptr_t memory = ALIGN_PTR(base + LOGGER_SIZE_BASE, ALIGNOF(page_list *)) + LOGGER_TABLE_SIZE(persist->page_amount);
+    logger_layout_pages(persist, memory, index, entry, buffer);
 }
-#else
-void *mallocv(int size) 
-{ 
-    return malloc(size); 
+
+int logger_persist_check(const logger_persist *persist, size_t len)
+{
+    if (len < sizeof(struct logger_t)
+        || persist->magic != LOGGER_PERSIST_MAGIC || persist->version != LOGGER_PERSIST_VERSION
+        || persist->header_size != sizeof(struct logger_t) || persist->entry_size != sizeof(page_list)
+        || persist->crc != logger_crc32(0, persist, offsetof(logger_persist, crc))) {
+        return -1; // Never stamped, stamped by another build, or damaged
+    }
+
+    const size_t align = persist->buffer_alignment;
+    if (persist->page_amount <= 0 || persist->page_size < 2 || persist->layout > LOGGER_LAYOUT_SPLIT
+        || align < ALIGNOF(page_list) || (align & (align - 1)) != 0) {
+        return -1;
+    }
+    const size_t alloc_size = logger_arena_size(persist->page_amount, persist->page_size,
+                                                (logger_layout_t)persist->layout, align);
+    if (alloc_size != persist->alloc_size || alloc_size > len) {
+        return -1;
+    }
+    return 0;
 }
-void freev(void *object) 
+
+// --- Page initialization with correct alignment ---
+void page_init_empty(LoggerHandler logger, page_list *page, char *buffer)
 {
-    free(object); 
+    page->buffer = buffer;
+    page->high_water = 0;
+    page->foreign = 0;
+    memset(page->buffer, 0, logger->page_buffer_size); // Record readers rely on unwritten headers reading as zero
+    atomic_init(&page->used, 0);
+    atomic_init(&page->sealed, -1);
+    atomic_init(&page->format, PAGE_FORMAT_EMPTY);
+    atomic_init(&page->epoch, 0);
+    page->type = PAGE_TYPE_DEFAULT;
+    page_summary_reset(page, logger->clock());
 }
-#endif
 
-typedef struct page_list {
-    page_type_t type;
-    int remaining;
-    char *buffer;
-    struct list_head list;
-} page_list;
+// A fresh arena gets empty pages; an adopted one keeps the pages as they were left
+static void page_init(LoggerHandler logger, int adopt)
+{
+    const int page_amount = logger->total_pages;
+    const int page_size = logger->page_buffer_size;
 
-struct logger_t {
-    int page_buffer_size;
-    int total_pages;
-    page_list pages;
-};
+    INIT_LIST_HEAD(&logger->pages.list);
 
-// --- Alignment-aware block size calculation ---
-#define LOGGER_SIZE_BASE (sizeof(struct logger_t))
+    // Same geometry the persistent header describes
+    logger_persist geometry;
+    geometry.page_amount = page_amount;
+    geometry.page_size = page_size;
+    geometry.buffer_alignment = logger->buffer_alignment;
+    geometry.layout = (uint16_t)logger->layout;
+    const uintptr_t memory_end = (uintptr_t)logger + logger->alloc_size;
+
+    for (int i = 0; i < page_amount; i++) {
+        uintptr_t entry, buffer;
+        logger_layout_page(&geometry, (uintptr_t)logger, i, &entry, &buffer);
+        page_list *new_page = (page_list *)entry;
+        if (adopt) {
+            new_page->buffer = (char *)buffer;
+            new_page->high_water = 0; // Statistics start over, also for adopted pages
+        }
+        else {
+            page_init_empty(logger, new_page, (char *)buffer);
+        }
 
-// Each block: aligned page_list + aligned buffer (with padding)
-#define LOGGER_BLOCK_SIZE(page_size) \
-    (ALIGN_PTR(sizeof(page_list), ALIGNOF(page_list)) \
-    + ALIGN_PTR(page_size, BUFFER_ALIGNMENT))
+        uintptr_t buffer_end = (uintptr_t)new_page->buffer + page_size;
+        assert(buffer_end <= memory_end);
 
-// Total allocation size
-#define LOGGER_ALLOC_SIZE(pages, size) \
-    (LOGGER_SIZE_BASE + (pages) * LOGGER_BLOCK_SIZE(size) + BUFFER_ALIGNMENT)
+        logger->page_table[i] = new_page;
+        logger_page_add(&logger->pages, new_page);
+    }
+}
 
-// --- List manipulation helpers (assume Linux-style list_head) ---
-static void logger_page_add(page_list *main, page_list *page) 
+// --- Default sink, used until logger_set_sink() is called ---
+static int logger_stdout_write(void *ctx, const char *data, int length)
 {
-    list_add_tail(&page->list, &main->list);
+    (void)ctx;
+    return (int)fwrite(data, 1, length, stdout);
 }
 
-// --- Page initialization with correct alignment ---
-static void page_init(page_list *pages, uint8_t *memory, int page_amount, int page_size)
+static const logger_sink_t logger_stdout_sink = { logger_stdout_write, NULL, NULL };
+
+// --- Persistent header ---
+uint32_t logger_crc32(uint32_t crc, const void *data, size_t length)
 {
-    const size_t entry_align = ALIGNOF(page_list);
-    uintptr_t mem_addr = ALIGN_PTR(memory, entry_align);
-    memory = (uint8_t *)mem_addr;
+    const uint8_t *bytes = data;
+    crc = ~crc;
+    while (length--) {
+        crc ^= *bytes++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
 
-    INIT_LIST_HEAD(&pages->list);
+// Shown instead of deferred records adopted from another image; its address identifies this one
+static const char deferred_lost[] = "<deferred record lost>";
 
-    const size_t block_size = LOGGER_BLOCK_SIZE(page_size);
-    const uintptr_t memory_end = (uintptr_t)memory + (page_amount + 2) * block_size;
+// Differs when the arena was stamped by other firmware or a relocated executable
+static uint32_t logger_image_id(void)
+{
+    const uint64_t address = (uintptr_t)deferred_lost;
+    return (uint32_t)address ^ (uint32_t)(address >> 32);
+}
 
-    for (int i = 0; i < page_amount; i++) {
-        // Align each block for page_list
-        uintptr_t block = (uintptr_t)memory + i * block_size;
-        page_list *new_page = (page_list *)ALIGN_PTR(block, entry_align);
-
-        // Align buffer after page_list struct
-        uintptr_t buf_start = ALIGN_PTR((uintptr_t)(new_page + 1), BUFFER_ALIGNMENT);
-        new_page->buffer = (char *)buf_start;
-        new_page->buffer[0] = '\0'; // Initialize first byte
-        new_page->buffer[1] = '\0'; // Initialize second byte
-        new_page->remaining = page_size;
-        new_page->type = PAGE_TYPE_DEFAULT;
+static void logger_persist_stamp(LoggerHandler logger)
+{
+    logger_persist *persist = &logger->persist;
+    memset(persist, 0, sizeof(*persist)); // Padding is covered by the CRC too
+    persist->magic = LOGGER_PERSIST_MAGIC;
+    persist->version = LOGGER_PERSIST_VERSION;
+    persist->header_size = sizeof(struct logger_t);
+    persist->entry_size = sizeof(page_list);
+    persist->layout = (uint16_t)logger->layout;
+    persist->page_amount = logger->total_pages;
+    persist->page_size = logger->page_buffer_size;
+    persist->buffer_alignment = logger->buffer_alignment;
+    persist->flags = logger->flags & LOGGER_PERSIST_FLAGS;
+    persist->base = (uintptr_t)logger;
+    persist->alloc_size = logger->alloc_size;
+    persist->image = logger_image_id();
+    persist->crc = logger_crc32(0, persist, offsetof(logger_persist, crc));
+}
 
-        uintptr_t buffer_end = (uintptr_t)new_page->buffer + page_size;
-        assert(buffer_end <= memory_end);
+static void logger_stats_clear(logger_stats_block *stats)
+{
+    atomic_store_explicit(&stats->bytes, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->records, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->truncations, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->drops, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->filtered, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->flushes, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->rotations, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->shed, 0, memory_order_relaxed);
+    atomic_store_explicit(&stats->max_append_ns, 0, memory_order_relaxed);
+}
 
-        logger_page_add(pages, new_page);
+// Runtime state, never trusted from a previous run
+static void logger_init_runtime(LoggerHandler logger)
+{
+    atomic_flag_clear(&logger->rotate_lock);
+    logger->sink = logger_stdout_sink;
+    atomic_init(&logger->pending, 0);
+    logger->draining = NULL;
+    logger->drain = NULL;
+    logger->map.fd = -1;
+    logger->map.addr = NULL;
+    logger->map.length = 0;
+    logger->archive = NULL;
+    logger->pool = NULL;
+    logger->isr = NULL;
+    logger->clock = logger_clock_us;
+    atomic_init(&logger->min_rank, LOGFLOW_LEVEL_DEBUG);
+    logger->overflow_depth = 0;
+    for (int rank = 0; rank < LOGFLOW_LEVEL_NONE; rank++) {
+        logger->overflow_floor[rank] = 0;
     }
+    logger_stats_clear(&logger->stats);
 }
+
 // --- Logger creation ---
-LoggerHandler logger_create(int page_amount, int page_size) 
+// LOGGER_REQUIRED_SIZE() is public and cannot see the structures, keep its bounds honest
+_Static_assert(LOGGER_SIZE_BASE + ALIGNOF(struct logger_t) + BUFFER_ALIGNMENT + 2 * ALIGNOF(page_list)
+               <= LOGGER_STATIC_BASE_SIZE, "LOGGER_STATIC_BASE_SIZE too small for logger_t");
+_Static_assert(sizeof(page_list *) + ALIGN_PTR(sizeof(page_list), ALIGNOF(page_list))
+               <= LOGGER_STATIC_PAGE_OVERHEAD, "LOGGER_STATIC_PAGE_OVERHEAD too small for page_list");
+_Static_assert(BUFFER_ALIGNMENT <= 8, "LOGGER_REQUIRED_SIZE() rounds page sizes to 8 bytes");
+
+// Builds a logger in memory when given, in a fresh allocation otherwise
+LoggerHandler logger_create_in(const logger_config_t *config, void *memory, size_t length)
 {
+    int page_amount = config->page_amount;
+    int page_size = config->page_size;
     if (page_amount <= 0 || page_size <= 0) {
         return NULL; // Invalid parameters
     }
@@ -116,20 +252,49 @@ LoggerHandler logger_create(int page_amount, int page_size)
         page_size = 2; // Ensure minimum size for buffer
     }
 
-    const size_t block_size = LOGGER_BLOCK_SIZE(page_size);
-    const size_t alloc_size = LOGGER_ALLOC_SIZE(page_amount, page_size);
+    size_t align = config->buffer_alignment;
+    if (align == 0) {
+        align = config->layout == LOGGER_LAYOUT_SPLIT ? LOGGER_CACHE_LINE_SIZE : BUFFER_ALIGNMENT;
+    }
+    if ((align & (align - 1)) != 0) {
+        return NULL; // Not a power of two
+    }
+    if (align < ALIGNOF(page_list)) {
+        align = ALIGNOF(page_list); // Inline entries start at buffer boundaries
+    }
+
+    const size_t alloc_size = logger_arena_size(page_amount, page_size, config->layout, align);
+
+    uint32_t flags = config->ring ? LOGGER_FLAG_RING : 0;
+    if (memory != NULL) {
+        uintptr_t start = ALIGN_PTR(memory, ALIGNOF(struct logger_t));
+        if (start - (uintptr_t)memory + alloc_size > length) {
+            return NULL; // Region too small
+        }
+        memory = (void *)start;
+        flags |= LOGGER_FLAG_STATIC;
+    }
+    else {
+        memory = mallocv(alloc_size);
+    }
 
-    void *memory = mallocv(alloc_size);
     if (memory != NULL) {
         LoggerHandler logger = (LoggerHandler)memory;
         logger->page_buffer_size = page_size;
         logger->total_pages = page_amount;
+        logger->flags = flags;
+        logger->layout = config->layout;
+        logger->buffer_alignment = (int)align;
+        logger->alloc_size = alloc_size;
+        logger_init_runtime(logger);
 
         uintptr_t raw = (uintptr_t)((unsigned char *)logger + LOGGER_SIZE_BASE);
-        uintptr_t aligned = ALIGN_PTR(raw, ALIGNOF(page_list));
-        uint8_t *ptr = (uint8_t *)aligned;
+        logger->page_table = (page_list **)ALIGN_PTR(raw, ALIGNOF(page_list *));
 
-        page_init(&logger->pages, ptr, page_amount, page_size);
+        page_init(logger, 0);
+        atomic_init(&logger->head, logger->page_table[0]);
+        atomic_init(&logger->tail, logger->page_table[0]);
+        logger_persist_stamp(logger); // Last, a half-built arena never validates
         return logger;
     } 
     else {
@@ -137,7 +302,185 @@ LoggerHandler logger_create(int page_amount, int page_size)
     }
 }
 
-static const char *logger_print_start_message_section(page_type_t type)
+LoggerHandler logger_create(int page_amount, int page_size) 
+{
+    logger_config_t config = LOGGER_CONFIG_DEFAULT(page_amount, page_size);
+    return logger_create_in(&config, NULL, 0);
+}
+
+LoggerHandler logger_create_ring(int page_amount, int page_size)
+{
+    logger_config_t config = LOGGER_CONFIG_DEFAULT(page_amount, page_size);
+    config.ring = 1;
+    return logger_create_in(&config, NULL, 0);
+}
+
+LoggerHandler logger_create_ex(const logger_config_t *config)
+{
+    return config != NULL ? logger_create_in(config, NULL, 0) : NULL;
+}
+
+LoggerHandler logger_create_static(void *mem, size_t len, int page_amount, int page_size)
+{
+    if (mem == NULL) {
+        return NULL;
+    }
+    logger_config_t config = LOGGER_CONFIG_DEFAULT(page_amount, page_size);
+    return logger_create_in(&config, mem, len);
+}
+
+static void page_reset(LoggerHandler logger, page_list *page);
+
+// Settles a page left behind by a previous run. Records stop at the first one that
+// was never committed; the head page continues from there, the others stay closed.
+// Deferred records of a foreign image keep their bytes, page->foreign hides their formats.
+static void page_adopt(LoggerHandler logger, page_list *page, int is_head, int foreign)
+{
+    const int size = logger->page_buffer_size;
+    unsigned char format = atomic_load_explicit(&page->format, memory_order_relaxed);
+    int used = atomic_load_explicit(&page->used, memory_order_relaxed);
+
+    if (format > PAGE_FORMAT_RECORD || used < 0 || (format != PAGE_FORMAT_RECORD && used > size - 1)
+        || page->type < PAGE_TYPE_ERROR || page->type > PAGE_TYPE_WARNING) {
+        memset(page->buffer, 0, size); // Nothing here can be trusted
+        atomic_store_explicit(&page->epoch, 0, memory_order_relaxed);
+        page_reset(logger, page);
+        return;
+    }
+    // The summary is rebuilt from the records, the stored one may be torn
+    const record_header *first = (const record_header *)page->buffer;
+    page_summary_reset(page, format == PAGE_FORMAT_RECORD ? first->timestamp : 0);
+    if (format != PAGE_FORMAT_RECORD) {
+        page->foreign = 0;
+        return; // Text offsets are only published after the copy
+    }
+
+    const uint32_t tag = page_commit_tag(page);
+    const int limit = used < size ? used : size;
+    int offset = 0;
+    while (offset + (int)sizeof(record_header) <= limit) {
+        const record_header *header = (const record_header *)(page->buffer + offset);
+        if (atomic_load_explicit(&header->commit, memory_order_relaxed) != tag
+            || header->slot < sizeof(record_header) || header->slot % RECORD_ALIGNMENT != 0
+            || offset + header->slot > limit) {
+            break;
+        }
+        if (header->kind != RECORD_KIND_PADDING) {
+            page_summary_add(page, (page_type_t)header->level, header->timestamp);
+            if (header->tag != 0) {
+                page_summary_tag(page, header->tag);
+            }
+        }
+        offset += header->slot;
+    }
+
+    // Records adopted from another image before stay hidden after this one restarts
+    if (foreign || page->foreign > offset) {
+        page->foreign = offset;
+    }
+    else if (page->foreign < 0) {
+        page->foreign = 0;
+    }
+
+    if (is_head) {
+        atomic_store_explicit(&page->used, offset, memory_order_relaxed);
+        atomic_store_explicit(&page->sealed, -1, memory_order_relaxed);
+    }
+    else {
+        atomic_store_explicit(&page->used, size + 1, memory_order_relaxed);
+        atomic_store_explicit(&page->sealed, offset, memory_order_relaxed);
+    }
+}
+
+LoggerHandler logger_attach_existing(void *mem, size_t len)
+{
+    if (mem == NULL) {
+        return NULL;
+    }
+    uintptr_t start = ALIGN_PTR(mem, ALIGNOF(struct logger_t));
+    if (start - (uintptr_t)mem + sizeof(struct logger_t) > len) {
+        return NULL;
+    }
+
+    LoggerHandler logger = (LoggerHandler)start;
+    const logger_persist *persist = &logger->persist;
+    if (logger_persist_check(persist, len - (start - (uintptr_t)mem)) != 0) {
+        return NULL;
+    }
+    const size_t align = persist->buffer_alignment;
+    const size_t alloc_size = persist->alloc_size;
+
+    // Pointers saved in the arena refer to where it lived before, possibly elsewhere
+    const uintptr_t old_base = (uintptr_t)persist->base;
+    const uintptr_t old_head = (uintptr_t)atomic_load_explicit(&logger->head, memory_order_relaxed);
+
+    logger->page_buffer_size = persist->page_size;
+    logger->total_pages = persist->page_amount;
+    logger->flags = (persist->flags & LOGGER_PERSIST_FLAGS) | LOGGER_FLAG_STATIC;
+    logger->layout = (logger_layout_t)persist->layout;
+    logger->buffer_alignment = (int)align;
+    logger->alloc_size = alloc_size;
+    logger_init_runtime(logger);
+
+    logger->page_table = (page_list **)ALIGN_PTR(start + LOGGER_SIZE_BASE, ALIGNOF(page_list *));
+    page_init(logger, 1);
+
+    page_list *head = logger->page_table[0];
+    for (int i = 0; i < logger->total_pages; i++) {
+        if ((uintptr_t)logger->page_table[i] - start + old_base == old_head) {
+            head = logger->page_table[i];
+            break;
+        }
+    }
+    // Format pointers of deferred records only mean something to the program that stored them
+    const int foreign = persist->image != logger_image_id();
+    for (int i = 0; i < logger->total_pages; i++) {
+        page_adopt(logger, logger->page_table[i], logger->page_table[i] == head, foreign);
+    }
+    atomic_store_explicit(&logger->head, head, memory_order_relaxed);
+    atomic_store_explicit(&logger->tail, head, memory_order_relaxed);
+
+    logger_persist_stamp(logger); // Now based at the new address
+    return logger;
+}
+
+LoggerHandler logger_create_mapped(const char *path, int page_amount, int page_size)
+{
+    if (path == NULL || page_amount <= 0 || page_size <= 0) {
+        return NULL;
+    }
+    if (page_size < 2) {
+        page_size = 2; // Same minimum as logger_create()
+    }
+    const size_t length = LOGGER_REQUIRED_SIZE(page_amount, page_size);
+
+    // Keep what a previous run left in the file as long as the geometry matches
+    logger_map_t map;
+    if (logger_map_open(&map, path, 0) == 0) {
+        LoggerHandler logger = map.length == length ? logger_attach_existing(map.addr, map.length) : NULL;
+        if (logger != NULL && logger->total_pages == page_amount && logger->page_buffer_size == page_size
+            && logger->layout == LOGGER_LAYOUT_INLINE) {
+            logger->flags |= LOGGER_FLAG_MAPPED;
+            logger->map = map;
+            return logger;
+        }
+        logger_map_close(&map);
+    }
+
+    if (logger_map_open(&map, path, length) != 0) {
+        return NULL;
+    }
+    LoggerHandler logger = logger_create_static(map.addr, map.length, page_amount, page_size);
+    if (logger == NULL) {
+        logger_map_close(&map);
+        return NULL;
+    }
+    logger->flags |= LOGGER_FLAG_MAPPED;
+    logger->map = map;
+    return logger;
+}
+
+const char *logger_print_start_message_section(page_type_t type)
 {
     switch(type) {
         case PAGE_TYPE_ERROR:
@@ -155,62 +498,337 @@ static const char *logger_print_start_message_section(page_type_t type)
     }
 }
 
-void puts_no_newline(const char* s) {
-    while (*s) putchar(*s++);
+// --- Batched output ---
+void logger_out_flush(logger_out *out)
+{
+    if (out->length > 0) {
+        out->sink->write(out->sink->ctx, out->buffer, out->length);
+        out->length = 0;
+    }
 }
 
-void logger_print_page_line(LoggerHandler logger, int page_index)
+void logger_out_end(logger_out *out)
 {
-    page_list *current, *tmp;
-    int index = 0;
+    logger_out_flush(out);
+    if (out->sink->flush != NULL) {
+        out->sink->flush(out->sink->ctx);
+    }
+}
 
-    list_for_each_entry_safe(current, tmp, &logger->pages.list, list) {
-        if (index == page_index) {
-            const char *end = current->buffer + logger->page_buffer_size; /* point to the end of the buffer */
-            const char *start_message = logger_print_start_message_section(current->type);
-            
-            puts_no_newline(start_message);
-            for (char *c = current->buffer; c != end && *c != '\n'; c++) {
-                putchar(*c);
-            }
+void logger_out_write(logger_out *out, const char *data, int length)
+{
+    if (length <= 0) {
+        return;
+    }
+    if (out->length + length > LOGGER_OUT_BUFFER_SIZE) {
+        logger_out_flush(out);
+        if (length >= LOGGER_OUT_BUFFER_SIZE) {
+            out->sink->write(out->sink->ctx, data, length); // Big span goes out as is
             return;
         }
-        index++;
     }
+    memcpy(out->buffer + out->length, data, length);
+    out->length += length;
 }
 
-void logger_print_page(LoggerHandler logger, int page_index, logger_command_t command)
+void logger_out_printf(logger_out *out, const char *fmt, ...)
 {
-    page_list *current, *tmp;
-    int index = 0;
+    char tmp[64];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(tmp, sizeof(tmp), fmt, args);
+    va_end(args);
+    if (n > 0) {
+        logger_out_write(out, tmp, n < (int)sizeof(tmp) ? n : (int)sizeof(tmp) - 1);
+    }
+}
 
-    list_for_each_entry_safe(current, tmp, &logger->pages.list, list) {
-        if (index == page_index) {
-            printf("Page%d:\n%s\n", index, current->buffer);
-            if (command == LOGGER_FLUSH) {
-                logger_flush_page(logger, page_index);
+void logger_out_emit(void *ctx, const char *data, int length)
+{
+    logger_out_write((logger_out *)ctx, data, length);
+}
+
+void logger_set_sink(LoggerHandler logger, const logger_sink_t *sink)
+{
+    if (logger == NULL) {
+        return;
+    }
+    logger->sink = (sink != NULL && sink->write != NULL) ? *sink : logger_stdout_sink;
+}
+
+// Text held by a text page. Pages never written through the API may still have been
+// filled via logger_get_page_buffer(), so those fall back to the string length.
+int page_text_length(LoggerHandler logger, page_list *page)
+{
+    if (atomic_load_explicit(&page->format, memory_order_acquire) == PAGE_FORMAT_TEXT) {
+        return page_used(logger, page);
+    }
+    return (int)strnlen(page->buffer, logger->page_buffer_size);
+}
+
+void logger_record_render(const page_list *page, const record_header *record, logger_emit_fn emit, void *ctx)
+{
+    if (page_record_foreign(page, record)) {
+        emit(ctx, deferred_lost, (int)sizeof(deferred_lost) - 1); // The arguments are ignored
+        return;
+    }
+    logger_format_render(RECORD_DATA(record), record->length, emit, ctx);
+}
+
+// Prints a record as "[timestamp] level: payload", rendering deferred formats on the way
+void logger_print_record(logger_out *out, const page_list *page, const record_header *record)
+{
+    logger_out_printf(out, "[%lu] ", (unsigned long)record->timestamp);
+    logger_out_puts(out, logger_print_start_message_section((page_type_t)record->level));
+    if (record->kind == RECORD_KIND_DEFERRED) {
+        logger_record_render(page, record, logger_out_emit, out);
+        return;
+    }
+    if (record->kind == RECORD_KIND_TAGGED) {
+        char unknown[LOGGER_TAG_UNKNOWN_SIZE];
+        const char *tag;
+        const int length = logger_tag_text(record->tag, unknown, &tag);
+        logger_out_write(out, tag, length);
+        logger_out_write(out, ": ", 2);
+    }
+    logger_out_write(out, RECORD_DATA(record), record->length);
+}
+
+void logger_print_page_line(LoggerHandler logger, int page_index)
+{
+    page_list *current = logger_get_page(logger, page_index);
+    if (current == NULL) {
+        return;
+    }
+
+    logger_out out;
+    logger_out_init(&out, logger);
+
+    if (atomic_load_explicit(&current->format, memory_order_acquire) == PAGE_FORMAT_RECORD) {
+        int offset = 0;
+        const record_header *record = page_next_record(logger, current, &offset);
+        if (record != NULL) {
+            logger_print_record(&out, current, record);
+        }
+    }
+    else {
+        const int length = page_text_length(logger, current);
+        const char *line_end = logger_scan_byte(current->buffer, length, '\n');
+        logger_out_puts(&out, logger_print_start_message_section(current->type));
+        logger_out_write(&out, current->buffer, line_end ? (int)(line_end - current->buffer) : length);
+    }
+    logger_out_end(&out);
+}
+
+// Prints the committed records of a record page matching level_mask, one per line
+// --- Line iteration ---
+typedef struct {
+    char *buffer;
+    int length;
+} line_render;
+
+static void line_render_emit(void *ctx, const char *data, int length)
+{
+    line_render *line = ctx;
+    int n = LOGGER_LINE_RENDER_SIZE - line->length < length ? LOGGER_LINE_RENDER_SIZE - line->length : length;
+    memcpy(line->buffer + line->length, data, n);
+    line->length += n;
+}
+
+int logger_record_text(const page_list *page, const record_header *record, char *rendered, const char **text)
+{
+    if (record->kind != RECORD_KIND_DEFERRED && record->kind != RECORD_KIND_TAGGED) {
+        *text = RECORD_DATA(record);
+        return record->length;
+    }
+    line_render line = { rendered, 0 };
+    if (record->kind == RECORD_KIND_TAGGED) {
+        char unknown[LOGGER_TAG_UNKNOWN_SIZE];
+        const char *tag;
+        const int length = logger_tag_text(record->tag, unknown, &tag);
+        line_render_emit(&line, tag, length);
+        line_render_emit(&line, ": ", 2);
+        line_render_emit(&line, RECORD_DATA(record), record->length);
+    }
+    else {
+        logger_record_render(page, record, line_render_emit, &line);
+    }
+    *text = rendered;
+    return line.length;
+}
+
+int logger_page_iterate_lines(LoggerHandler logger, int page_index, logger_line_fn fn, void *ctx)
+{
+    page_list *current = logger_get_page(logger, page_index);
+    if (current == NULL || fn == NULL) {
+        return -1;
+    }
+
+    int lines = 0;
+    if (atomic_load_explicit(&current->format, memory_order_acquire) == PAGE_FORMAT_RECORD) {
+        // One line per record, payload only
+        char rendered[LOGGER_LINE_RENDER_SIZE];
+        int offset = 0;
+        const record_header *record;
+        while ((record = page_next_record(logger, current, &offset)) != NULL) {
+            lines++;
+            const char *text;
+            const int length = logger_record_text(current, record, rendered, &text);
+            if (fn(ctx, text, length)) {
+                break;
             }
-            return;
         }
-        index++;
+        return lines;
+    }
+
+    const char *p = current->buffer;
+    const char *end = p + page_text_length(logger, current);
+    while (p < end) {
+        const char *line_end = logger_scan_byte(p, (int)(end - p), '\n');
+        const char *next = line_end != NULL ? line_end + 1 : end;
+        lines++;
+        if (fn(ctx, p, (int)((line_end != NULL ? line_end : end) - p))) {
+            break;
+        }
+        p = next;
+    }
+    return lines;
+}
+
+int logger_page_count_lines(LoggerHandler logger, int page_index)
+{
+    page_list *current = logger_get_page(logger, page_index);
+    if (current == NULL) {
+        return -1;
+    }
+
+    if (atomic_load_explicit(&current->format, memory_order_acquire) == PAGE_FORMAT_RECORD) {
+        int lines = 0;
+        int offset = 0;
+        while (page_next_record(logger, current, &offset) != NULL) {
+            lines++;
+        }
+        return lines;
+    }
+
+    const int length = page_text_length(logger, current);
+    int lines = logger_count_byte(current->buffer, length, '\n');
+    if (length > 0 && current->buffer[length - 1] != '\n') {
+        lines++; // Last line without a line break
+    }
+    return lines;
+}
+
+static void logger_print_records(logger_out *out, LoggerHandler logger, page_list *page, uint32_t level_mask)
+{
+    int offset = 0;
+    const record_header *record;
+    while ((record = page_next_record(logger, page, &offset)) != NULL) {
+        if (record_matches(record, level_mask)) {
+            logger_print_record(out, page, record);
+            logger_out_write(out, "\n", 1);
+        }
+    }
+}
+
+// Prints the content of any page, records or text
+void logger_print_content(logger_out *out, LoggerHandler logger, page_list *page)
+{
+    const uint32_t cycles = logger_profile_begin();
+    if (atomic_load_explicit(&page->format, memory_order_acquire) == PAGE_FORMAT_RECORD) {
+        logger_print_records(out, logger, page, LOGGER_LEVEL_ALL);
+    }
+    else {
+        logger_out_write(out, page->buffer, page_text_length(logger, page));
+    }
+    logger_profile_end(LOGGER_PROFILE_PRINT, cycles);
+}
+
+void logger_print_page(LoggerHandler logger, int page_index, logger_command_t command)
+{
+    page_list *current = logger_get_page(logger, page_index);
+    if (current == NULL) {
+        return;
+    }
+
+    logger_out out;
+    logger_out_init(&out, logger);
+    logger_out_printf(&out, "Page%d:\n", page_index);
+    logger_print_content(&out, logger, current);
+    logger_out_write(&out, "\n", 1);
+    logger_out_end(&out);
+
+    if (command == LOGGER_FLUSH) {
+        logger_flush_page(logger, page_index);
     }
 }
 
 void logger_print_all(LoggerHandler logger) 
 {
-    struct page_list *current, *tmp;
-    list_for_each_entry_safe(current, tmp, &logger->pages.list, list) {
-        printf("remaining: %i", current->remaining);
-        printf("---[");
-        printf("%s", current->buffer);
-        printf("]---\n");
+    logger_out out;
+    logger_out_init(&out, logger);
+
+    if (logger->archive != NULL) {
+        logger_archive_print(&out, logger, LOGGER_LEVEL_ALL, 1); // Older than any page
+    }
+
+    page_list *first = logger_oldest_page(logger);
+    page_list *current = first;
+    do {
+        logger_out_printf(&out, "remaining: %i---[", page_remaining(logger, current));
+        logger_print_content(&out, logger, current);
+        logger_out_puts(&out, "]---\n");
+        current = page_next(logger, current);
+    } while (current != first);
+    logger_out_end(&out);
+}
+
+void logger_print_filtered(LoggerHandler logger, uint32_t level_mask)
+{
+    logger_out out;
+    logger_out_init(&out, logger);
+    if (logger->archive != NULL) {
+        logger_archive_print(&out, logger, level_mask, 0);
     }
+
+    page_list *first = logger_oldest_page(logger);
+    page_list *current = first;
+    do {
+        const uint32_t cycles = logger_profile_begin();
+        unsigned char format = atomic_load_explicit(&current->format, memory_order_acquire);
+        if (format == PAGE_FORMAT_RECORD) {
+            logger_print_records(&out, logger, current, level_mask);
+        }
+        else if (format == PAGE_FORMAT_TEXT && (level_mask & LOGGER_LEVEL_MASK(current->type))) {
+            logger_out_puts(&out, logger_print_start_message_section(current->type));
+            logger_out_write(&out, current->buffer, page_text_length(logger, current));
+        }
+        logger_profile_end(LOGGER_PROFILE_PRINT, cycles);
+        current = page_next(logger, current);
+    } while (current != first);
+    logger_out_end(&out);
 }
 
 // --- Logger destroy ---
 void logger_destroy(LoggerHandler logger) 
 {
-    freev(logger);
+    if (logger == NULL) {
+        return;
+    }
+    logger_drain_stop(logger); // Writes out what is left before the memory goes away
+    logger_isr_free(logger);
+    logger_archive_free(logger);
+    logger_pool_free(logger);
+    if (logger->flags & LOGGER_FLAG_MAPPED) {
+        logger_map_t map = logger->map; // Lives inside the mapping
+        logger_map_close(&map); // The file keeps the logs, it stays attachable
+    }
+    else if (logger->flags & LOGGER_FLAG_STATIC) {
+        logger->persist.magic = 0; // Destroyed on purpose, do not attach to it again
+    }
+    else {
+        freev(logger);
+    }
 }
 
 // --- Logger debug dump ---
@@ -219,11 +837,21 @@ void logger_debug_dump(LoggerHandler logger)
 {
     page_list *current, *tmp;
     int index = 0;
+    int shared_lines = 0;
+    const uintptr_t line = LOGGER_CACHE_LINE_SIZE;
 
     printf("🔍 Logger Memory Map Dump\n");
+    printf("  Layout        : %s\n", logger->layout == LOGGER_LAYOUT_SPLIT
+           ? "split (metadata array, one entry per cache line)" : "inline (metadata before each buffer)");
+    printf("  Arena         : %p, %zu bytes\n", (void *)logger, logger->alloc_size);
+    printf("  Page entry    : %zu bytes, stride %zu\n", sizeof(page_list),
+           logger->layout == LOGGER_LAYOUT_SPLIT ? (size_t)LOGGER_META_STRIDE : logger_block_size(logger->page_buffer_size, logger->buffer_alignment));
+    printf("  Buffer        : %d bytes, alignment %d, cache line %d\n",
+           logger->page_buffer_size, logger->buffer_alignment, (int)line);
 
     list_for_each_entry_safe(current, tmp, &logger->pages.list, list) {
         uintptr_t entry_addr   = (uintptr_t)current;
+        uintptr_t entry_end    = entry_addr + sizeof(page_list);
         uintptr_t buffer_addr  = (uintptr_t)current->buffer;
         uintptr_t buffer_end   = buffer_addr + logger->page_buffer_size;
 
@@ -235,118 +863,858 @@ void logger_debug_dump(LoggerHandler logger)
         if (entry_addr % ALIGNOF(page_list) != 0)
             printf("Misaligned page_list struct!\n");
 
-        if (buffer_addr % BUFFER_ALIGNMENT != 0)
+        if (buffer_addr % logger->buffer_alignment != 0)
             printf("Misaligned buffer!\n");
 
+        // Cache lines holding both page metadata and buffer bytes get bounced between writers and readers
+        if ((entry_end - 1) / line == buffer_addr / line) {
+            shared_lines++;
+        }
+
         // Overlap detection
         if ((void *)tmp != (void *)(&logger->pages.list)) {
             uintptr_t next_entry = (uintptr_t)tmp;
-            if (buffer_end > next_entry) {
+            uintptr_t next_buffer = (uintptr_t)tmp->buffer;
+            if (buffer_addr < next_entry + sizeof(page_list) && next_entry < buffer_end) {
                 printf("     Overlap detected with next page!\n");
                 printf("     Buffer end: %p > Next entry: %p\n",
                        (void *)buffer_end, (void *)next_entry);
             }
+            if (buffer_addr < next_buffer + logger->page_buffer_size && next_buffer < buffer_end) {
+                printf("     Overlap detected with next buffer!\n");
+            }
+            if ((buffer_end - 1) / line == next_entry / line) {
+                shared_lines++; // Tail of this buffer next to the following entry
+            }
         }
         index++;
     }
+    printf("  Cache lines shared by metadata and buffers: %d\n", shared_lines);
     printf("  Dump complete: %d pages checked.\n", index);
 }
 
-static int __logger_add_data_helper(LoggerHandler logger, const char *data, int size, int index, const char end)
+// Appends fragments back to back with a single update of the write offset.
+// Inlined so the single fragment callers keep a straight memcpy.
+static inline __attribute__((always_inline)) int __logger_add_data_helper(LoggerHandler logger, const struct logger_iov *iov, int count, int index, const char end)
 {
-    if (index < logger->total_pages && index >= 0) {
-        if (size <= 0) {
-            size = strlen(data);
-        }
+    page_list *current = logger_get_page(logger, index);
+    if (current == NULL) {
+        return -1;
+    }
 
-        page_list *current, *tmp;
-        int page_index = 0;
+    if (page_claim_format(current, PAGE_FORMAT_TEXT) != 0) {
+        return -1; // Page holds records
+    }
 
-        list_for_each_entry_safe(current, tmp, &logger->pages.list, list) {
-            if (page_index == index) {
-                int offset = logger->page_buffer_size - current->remaining;
-                if (size > current->remaining) {
-                    size = current->remaining; // Limit size to remaining space
-                }
+    const uint32_t cycles = logger_profile_begin();
+    int size = 0;
+    for (int i = 0; i < count; i++) {
+        size += iov_length(&iov[i]);
+    }
 
-                if (end != '\0') {
-                    current->buffer[offset + size] = end; // Add end character if provided
-                    current->buffer[offset + size + 1] = '\0'; // Null-terminate the string
-                    current->remaining -= (size + 1); // Adjust remaining space
-                }
-                else {
-                    current->buffer[offset + size] = '\0'; // Null-terminate the string
-                    current->remaining -= size;
-                }
-                memcpy(current->buffer + offset, data, size);
-                return size;
-            }
-            page_index++;
-        }
+    int offset = atomic_load_explicit(&current->used, memory_order_relaxed);
+    // Keep room for the end character and the null terminator
+    int remaining = logger->page_buffer_size - offset - 1 - (end != '\0');
+    if (remaining < 0) {
+        LOGGER_STAT_ADD(logger, drops, 1);
+        return 0; // Page is full
     }
-    return -1;
+    if (size > remaining) {
+        if (remaining == 0) {
+            LOGGER_STAT_ADD(logger, drops, 1); // Nothing of it fits
+        }
+        else {
+            LOGGER_STAT_ADD(logger, truncations, 1);
+        }
+        size = remaining; // Limit size to remaining space
+    }
+
+    char *dst = current->buffer + offset;
+    for (int i = 0, left = size; i < count && left > 0; i++) {
+        int n = iov_length(&iov[i]);
+        n = n < left ? n : left;
+        memcpy(dst, iov[i].base, n);
+        dst += n;
+        left -= n;
+    }
+    if (end != '\0') {
+        current->buffer[offset + size] = end; // Add end character if provided
+        current->buffer[offset + size + 1] = '\0'; // Null-terminate the string
+        offset += size + 1; // Adjust remaining space
+    }
+    else {
+        current->buffer[offset + size] = '\0'; // Null-terminate the string
+        offset += size;
+    }
+    atomic_store_explicit(&current->used, offset, memory_order_release);
+    logger_profile_end(LOGGER_PROFILE_APPEND, cycles);
+    return size;
 }
 
 int logger_save_to_page(LoggerHandler logger, const char *data, int size, int index)
 {
-    return __logger_add_data_helper(logger, data, size, index, '\0');
+    const struct logger_iov iov = { data, size };
+    return __logger_add_data_helper(logger, &iov, 1, index, '\0');
 }
 
 int logger_save_to_page_line(LoggerHandler logger, const char *data, int size, int index)
 {
-    return __logger_add_data_helper(logger, data, size, index, '\n');
+    const struct logger_iov iov = { data, size };
+    return __logger_add_data_helper(logger, &iov, 1, index, '\n');
 }
 
-int logger_set_page_type(LoggerHandler logger, int page_index, page_type_t type)
+int logger_save_iov(LoggerHandler logger, const struct logger_iov *iov, int count, int index)
 {
-    page_list *current, *tmp;
-    int index = 0;
+    if (iov == NULL || count < 0) {
+        return -1;
+    }
+    return __logger_add_data_helper(logger, iov, count, index, '\0');
+}
 
-    list_for_each_entry_safe(current, tmp, &logger->pages.list, list) {
-        if (index == page_index) {
-            current->type = type;
-            return 0; // Success
+// Reserves span bytes of record slots on a page, returns their offset or -1
+static int page_reserve_span(LoggerHandler logger, page_list *current, int span)
+{
+    if (page_claim_format(current, PAGE_FORMAT_RECORD) != 0) {
+        return -1; // Page holds plain text
+    }
+
+    // Bail out early on a full page so failed reservations cannot keep growing the offset
+    if (atomic_load_explicit(&current->used, memory_order_relaxed) + span > logger->page_buffer_size) {
+        return -1;
+    }
+
+    int offset = atomic_fetch_add_explicit(&current->used, span, memory_order_relaxed);
+    if (offset + span > logger->page_buffer_size) {
+        // Lost the race for the last bytes of the page. The one reservation crossing the
+        // end marks where the valid records stop, every later one starts past the end.
+        if (offset <= logger->page_buffer_size) {
+            atomic_store_explicit(&current->sealed, offset, memory_order_release);
         }
-        index++;
+        return -1;
     }
-    return -1;
+    return offset;
 }
 
-char *logger_get_page_buffer(LoggerHandler logger, int page_index)
+// Fills in the header of a reserved slot, unpublished
+static record_header *record_init(page_list *current, int offset, int size, page_type_t level, uint32_t timestamp)
 {
-    page_list *current, *tmp;
-    int index = 0;
+    record_header *header = (record_header *)(current->buffer + offset);
+    // The slot may hold a record from an older generation; park the complement of the
+    // tag in it so it stays unpublished, record_publish() flips it back
+    atomic_store_explicit(&header->commit, ~page_commit_tag(current), memory_order_relaxed);
+    header->length = (uint16_t)size;
+    header->slot = (uint16_t)RECORD_SLOT_SIZE(size);
+    header->kind = RECORD_KIND_TEXT;
+    header->level = (int8_t)level;
+    header->tag = 0;
+    header->timestamp = timestamp;
+    page_summary_add(current, level, timestamp);
+    return header;
+}
 
-    list_for_each_entry_safe(current, tmp, &logger->pages.list, list) {
-        if (index == page_index) {
-            return current->buffer; // Return the buffer of the specified page
+// Reserves a record slot on a page, NULL if the page cannot take it.
+// The record stays invisible to readers until record_publish() is called.
+static record_header *page_reserve_record(LoggerHandler logger, page_list *current, int size, page_type_t level,
+                                          uint32_t timestamp)
+{
+    int offset = page_reserve_span(logger, current, RECORD_SLOT_SIZE(size));
+    if (offset < 0) {
+        return NULL;
+    }
+    return record_init(current, offset, size, level, timestamp);
+}
+
+// Accounts one published record, bytes are taken from the page fill levels instead
+static inline void logger_stat_record(LoggerHandler logger, uint32_t start)
+{
+    LOGGER_STAT_ADD(logger, records, 1);
+    logger_stat_end(logger, start);
+}
+
+static inline void record_publish(record_header *header)
+{
+    uint32_t pending = atomic_load_explicit(&header->commit, memory_order_relaxed);
+    atomic_store_explicit(&header->commit, ~pending, memory_order_release);
+}
+
+int logger_append_atomic(LoggerHandler logger, const char *data, int size, int index)
+{
+    page_list *current = logger_get_page(logger, index);
+    if (current == NULL || data == NULL) {
+        return -1;
+    }
+
+    if (size <= 0) {
+        size = strlen(data);
+    }
+    if (size > (int)RECORD_MAX_LENGTH) {
+        return -1; // Does not fit the record header
+    }
+
+    const uint32_t start = logger_stat_begin(logger);
+
+    const uint32_t cycles = logger_profile_begin();
+    record_header *header = page_reserve_record(logger, current, size, PAGE_TYPE_DEFAULT, logger->clock());
+    if (header == NULL) {
+        LOGGER_STAT_ADD(logger, drops, 1);
+        return -1;
+    }
+    memcpy(header + 1, data, size);
+    record_publish(header);
+    logger_stat_record(logger, start);
+    logger_profile_end(LOGGER_PROFILE_APPEND, cycles);
+    return size;
+}
+
+// Closes a record page to new reservations so its last record is known
+static void page_seal(LoggerHandler logger, page_list *page)
+{
+    if (atomic_load_explicit(&page->format, memory_order_acquire) != PAGE_FORMAT_RECORD) {
+        return; // Text pages have a single writer and are always settled
+    }
+    const int size = logger->page_buffer_size;
+    int offset = atomic_fetch_add_explicit(&page->used, size + 1, memory_order_relaxed);
+    if (offset <= size) {
+        atomic_store_explicit(&page->sealed, offset, memory_order_release);
+    }
+}
+
+void page_wait_settled(page_list *page)
+{
+    int end = atomic_load_explicit(&page->sealed, memory_order_acquire);
+    if (atomic_load_explicit(&page->format, memory_order_acquire) != PAGE_FORMAT_RECORD || end < 0) {
+        return;
+    }
+
+    // Every reservation below the seal succeeded, so each header there gets committed eventually
+    const uint32_t tag = page_commit_tag(page);
+    int spins = 0;
+    for (int offset = 0; offset + (int)sizeof(record_header) <= end; ) {
+        const record_header *header = (const record_header *)(page->buffer + offset);
+        if (atomic_load_explicit(&header->commit, memory_order_acquire) != tag) {
+            if (++spins < 1000) {
+                logger_spin_pause();
+            }
+            else {
+                logger_sleep_ms(1); // Producer was preempted, let it finish
+            }
+            continue;
         }
-        index++;
+        offset += header->slot;
     }
-    return NULL; // Page not found
 }
 
-void logger_flush_page(LoggerHandler logger, int page_index)
+int logger_free_pages(LoggerHandler logger, page_list *full, int limit)
 {
-    page_list *current, *tmp;
-    list_for_each_entry_safe(current, tmp, &logger->pages.list, list) {
-        if (page_index == 0) {
-            memset(current->buffer, 0, logger->page_buffer_size);
-            current->remaining = logger->page_buffer_size; // Reset remaining space
-            current->type = PAGE_TYPE_DEFAULT; // Reset type
-            return;
+    page_list *stop;
+    if (logger->drain != NULL) {
+        stop = atomic_load_explicit(&logger->tail, memory_order_relaxed); // Drained pages come back
+    }
+    else if (logger->flags & LOGGER_FLAG_RING) {
+        return limit + 1; // Overwrites the oldest page, never short
+    }
+    else {
+        stop = logger->page_table[0]; // Linear logger ends at its last page
+    }
+
+    int free = 0;
+    for (page_list *page = page_next(logger, full); page != stop && free <= limit; page = page_next(logger, page)) {
+        free++;
+    }
+    return free;
+}
+
+// Non-zero when the free pages left are kept for levels above this one
+static int rotate_sheds(LoggerHandler logger, page_list *full, page_type_t level)
+{
+    const int floor = logger->overflow_floor[LOGFLOW_LEVEL_RANK(level)];
+    return floor > 0 && logger_free_pages(logger, full, logger->overflow_depth) <= floor;
+}
+
+// Moves the head past a full page. Only the first producer to notice does the work,
+// the others find the head already moved and retry on the new page.
+int logger_rotate(LoggerHandler logger, page_list *full, page_type_t level)
+{
+    int result = 0;
+    int pending = 0;
+    int moved = 0;
+    struct logger_archive *staged = NULL;
+    int spins = 0;
+    logger_rotate_lock(logger);
+    // One page is compressed at a time, wait for the one before outside the lock
+    while (logger_archive_busy(logger) && atomic_load_explicit(&logger->head, memory_order_relaxed) == full) {
+        logger_rotate_unlock(logger);
+        if (++spins < 1000) {
+            logger_spin_pause();
+        }
+        else {
+            logger_sleep_ms(1);
+        }
+        logger_rotate_lock(logger);
+    }
+
+    if (atomic_load_explicit(&logger->head, memory_order_relaxed) == full) {
+        page_list *next = page_next(logger, full);
+        page_list *tail = atomic_load_explicit(&logger->tail, memory_order_relaxed);
+        int grown = 0;
+
+        if (logger->pool != NULL && logger_pool_grow(logger, full) == 0) {
+            next = page_next(logger, full); // First page of the new slab, empty already
+            grown = 1;
+        }
+        else if (rotate_sheds(logger, full, level)) {
+            result = -1; // Room kept for warnings and errors, see logger_set_overflow()
+            LOGGER_STAT_ADD(logger, shed, 1);
+        }
+        else if (logger->drain != NULL && next == tail) {
+            // Every other page still waits for the drain worker
+            if ((logger->flags & LOGGER_FLAG_RING) && next != logger->draining) {
+                atomic_store_explicit(&logger->tail, page_next(logger, next), memory_order_relaxed);
+                atomic_fetch_sub_explicit(&logger->pending, 1, memory_order_relaxed); // Drop the oldest
+            }
+            else {
+                result = -1; // Drop the new record instead
+            }
+        }
+        else if (logger->drain == NULL && next == logger->page_table[0] && !(logger->flags & LOGGER_FLAG_RING)) {
+            result = -1; // Linear logger ran out of pages
+        }
+
+        if (result == 0) {
+            page_seal(logger, full);
+            if (!grown) {
+                staged = logger_archive_stage(logger, next); // Compressed below, before it is lost
+                page_reset(logger, next); // Overwrite the oldest page
+            }
+            atomic_store_explicit(&logger->head, next, memory_order_release);
+            moved = 1;
+            LOGGER_STAT_ADD(logger, rotations, 1);
+            if (logger->drain != NULL) {
+                pending = atomic_fetch_add_explicit(&logger->pending, 1, memory_order_relaxed) + 1;
+            }
+        }
+    }
+
+    logger_rotate_unlock(logger);
+    if (staged != NULL) {
+        logger_archive_commit(logger, staged);
+    }
+    if (pending > 0) {
+        logger_drain_notify(logger, pending);
+    }
+    if (moved && (logger->flags & LOGGER_FLAG_MAPPED)) {
+        // Let the OS write the closed page back in the background
+        logger_map_sync_async(&logger->map, full, sizeof(page_list));
+        logger_map_sync_async(&logger->map, full->buffer, logger->page_buffer_size);
+    }
+    return result;
+}
+
+// Reserves a record on the head page, moving the head along until one fits;
+// *page receives the page it landed on
+static inline record_header *logger_reserve_head_on(LoggerHandler logger, int size, page_type_t level,
+                                                    uint32_t timestamp, page_list **page)
+{
+    if (size > (int)RECORD_MAX_LENGTH || (int)RECORD_SLOT_SIZE(size) > logger->page_buffer_size) {
+        return NULL; // Would not fit even on an empty page
+    }
+
+    for (;;) {
+        page_list *head = atomic_load_explicit(&logger->head, memory_order_acquire);
+        record_header *header = page_reserve_record(logger, head, size, level, timestamp);
+        if (header != NULL) {
+            *page = head;
+            return header;
+        }
+        if (logger_rotate(logger, head, level) != 0) {
+            return NULL;
+        }
+    }
+}
+
+static record_header *logger_reserve_head(LoggerHandler logger, int size, page_type_t level)
+{
+    page_list *page;
+    return logger_reserve_head_on(logger, size, level, logger->clock(), &page);
+}
+
+int logger_log(LoggerHandler logger, page_type_t level, const char *data, int size)
+{
+    if (logger == NULL || data == NULL) {
+        return -1;
+    }
+    if (!logger_level_passes(logger, level)) {
+        LOGGER_STAT_ADD(logger, filtered, 1);
+        return 0; // Filtered out by logger_set_level()
+    }
+
+    if (size <= 0) {
+        size = strlen(data);
+    }
+
+    const uint32_t start = logger_stat_begin(logger);
+
+    const uint32_t cycles = logger_profile_begin();
+    record_header *header = logger_reserve_head(logger, size, level);
+    if (header == NULL) {
+        LOGGER_STAT_ADD(logger, drops, 1);
+        return -1;
+    }
+    memcpy(header + 1, data, size);
+    record_publish(header);
+    logger_stat_record(logger, start);
+    logger_profile_end(LOGGER_PROFILE_APPEND, cycles);
+    return size;
+}
+
+// Copies the tag in front of the payload, or only refers to it when tag is NULL
+static int log_tagged(LoggerHandler logger, page_type_t level, uint16_t hash, const char *tag,
+                      const char *data, int size)
+{
+    if (size <= 0) {
+        size = strlen(data);
+    }
+    const int tag_length = tag != NULL ? (int)strlen(tag) : 0;
+    const int total = tag != NULL ? tag_length + 2 + size : size; // "tag: " prefix, so printed records show it
+
+    const uint32_t start = logger_stat_begin(logger);
+
+    const uint32_t cycles = logger_profile_begin();
+    page_list *page;
+    record_header *header = logger_reserve_head_on(logger, total, level, logger->clock(), &page);
+    if (header == NULL) {
+        LOGGER_STAT_ADD(logger, drops, 1);
+        return -1;
+    }
+    char *payload = (char *)(header + 1);
+    if (tag != NULL) {
+        memcpy(payload, tag, tag_length);
+        payload[tag_length] = ':';
+        payload[tag_length + 1] = ' ';
+        payload += tag_length + 2;
+    }
+    else {
+        header->kind = RECORD_KIND_TAGGED; // Readers put the registered tag back in front
+    }
+    memcpy(payload, data, size);
+    header->tag = hash;
+    page_summary_tag(page, hash);
+    record_publish(header);
+    logger_stat_record(logger, start);
+    logger_profile_end(LOGGER_PROFILE_APPEND, cycles);
+    return size;
+}
+
+int logger_log_tag(LoggerHandler logger, page_type_t level, const char *tag, const char *data, int size)
+{
+    if (logger == NULL || tag == NULL || data == NULL) {
+        return -1;
+    }
+    if (!logger_level_passes(logger, level)) {
+        LOGGER_STAT_ADD(logger, filtered, 1);
+        return 0;
+    }
+
+    const uint16_t hash = logger_tag_hash(tag);
+    const char *registered = logger_tag_lookup(hash, NULL);
+    if (registered != NULL && (registered == tag || strcmp(registered, tag) == 0)) {
+        tag = NULL; // Registered, the record only keeps the hash
+    }
+    return log_tagged(logger, level, hash, tag, data, size);
+}
+
+int logger_log_tag_id(LoggerHandler logger, page_type_t level, int tag_id, const char *data, int size)
+{
+    if (logger == NULL || data == NULL || tag_id <= 0 || tag_id > UINT16_MAX
+        || logger_tag_lookup((uint16_t)tag_id, NULL) == NULL) {
+        return -1;
+    }
+    if (!logger_level_passes(logger, level)) {
+        LOGGER_STAT_ADD(logger, filtered, 1);
+        return 0;
+    }
+    return log_tagged(logger, level, (uint16_t)tag_id, NULL, data, size);
+}
+
+int logger_log_at(LoggerHandler logger, page_type_t level, uint32_t timestamp, const char *data, int size)
+{
+    const uint32_t start = logger_stat_begin(logger);
+    const uint32_t cycles = logger_profile_begin();
+    page_list *page;
+    record_header *header = logger_reserve_head_on(logger, size, level, timestamp, &page);
+    if (header == NULL) {
+        LOGGER_STAT_ADD(logger, drops, 1);
+        return -1;
+    }
+    memcpy(header + 1, data, size);
+    record_publish(header);
+    logger_stat_record(logger, start);
+    logger_profile_end(LOGGER_PROFILE_APPEND, cycles);
+    return size;
+}
+
+int logger_write(LoggerHandler logger, const char *data, int size)
+{
+    return logger_log(logger, PAGE_TYPE_DEFAULT, data, size);
+}
+
+int logger_log_iov(LoggerHandler logger, page_type_t level, const struct logger_iov *iov, int count)
+{
+    if (logger == NULL || iov == NULL || count < 0) {
+        return -1;
+    }
+    if (!logger_level_passes(logger, level)) {
+        LOGGER_STAT_ADD(logger, filtered, 1);
+        return 0;
+    }
+
+    int size = 0;
+    for (int i = 0; i < count; i++) {
+        size += iov_length(&iov[i]);
+    }
+
+    const uint32_t start = logger_stat_begin(logger);
+
+    const uint32_t cycles = logger_profile_begin();
+    record_header *header = logger_reserve_head(logger, size, level);
+    if (header == NULL) {
+        LOGGER_STAT_ADD(logger, drops, 1);
+        return -1;
+    }
+    char *dst = (char *)(header + 1);
+    for (int i = 0; i < count; i++) {
+        const int n = iov_length(&iov[i]);
+        memcpy(dst, iov[i].base, n);
+        dst += n;
+    }
+    record_publish(header);
+    logger_stat_record(logger, start);
+    logger_profile_end(LOGGER_PROFILE_APPEND, cycles);
+    return size;
+}
+
+int logger_log_batch(LoggerHandler logger, page_type_t level, const struct logger_iov *messages, int count)
+{
+    if (logger == NULL || messages == NULL || count < 0) {
+        return -1;
+    }
+    if (!logger_level_passes(logger, level)) {
+        LOGGER_STAT_ADD(logger, filtered, count);
+        return 0;
+    }
+
+    int span = 0;
+    for (int i = 0; i < count && span <= logger->page_buffer_size; i++) {
+        const int size = iov_length(&messages[i]);
+        span = size > (int)RECORD_MAX_LENGTH ? logger->page_buffer_size + 1 : span + (int)RECORD_SLOT_SIZE(size);
+    }
+
+    // Whole batch on the head page with a single reservation
+    if (count > 0 && span <= logger->page_buffer_size) {
+        const uint32_t start = logger_stat_begin(logger);
+        const uint32_t cycles = logger_profile_begin();
+        page_list *head = atomic_load_explicit(&logger->head, memory_order_acquire);
+        int offset = page_reserve_span(logger, head, span);
+        if (offset >= 0) {
+            const uint32_t now = logger->clock();
+            for (int i = 0; i < count; i++) {
+                const int size = iov_length(&messages[i]);
+                record_header *header = record_init(head, offset, size, level, now);
+                memcpy(header + 1, messages[i].base, size);
+                record_publish(header);
+                offset += header->slot;
+            }
+            LOGGER_STAT_ADD(logger, records, count);
+            logger_stat_end(logger, start);
+            logger_profile_end(LOGGER_PROFILE_APPEND, cycles);
+            return count;
+        }
+    }
+
+    // Does not fit what is left of the head page, one reservation per record
+    int written = 0;
+    while (written < count
+           && logger_log(logger, level, messages[written].base, iov_length(&messages[written])) >= 0) {
+        written++;
+    }
+    return written;
+}
+
+int logger_reserve(LoggerHandler logger, int size, char **ptr)
+{
+    if (logger == NULL || ptr == NULL || size <= 0) {
+        return -1;
+    }
+
+    record_header *header = logger_reserve_head(logger, size, PAGE_TYPE_DEFAULT);
+    if (header == NULL) {
+        LOGGER_STAT_ADD(logger, drops, 1);
+        *ptr = NULL;
+        return -1;
+    }
+    *ptr = (char *)(header + 1);
+    return 0;
+}
+
+int logger_commit(LoggerHandler logger, char *ptr, int used)
+{
+    if (logger == NULL || ptr == NULL) {
+        return -1;
+    }
+
+    record_header *header = (record_header *)ptr - 1;
+    if (used < 0 || used > header->length) {
+        used = header->length; // Cannot grow past the reservation
+    }
+    if (used == 0) {
+        header->kind = RECORD_KIND_PADDING; // Nothing to keep, readers skip the slot
+    }
+    header->length = (uint16_t)used; // The slot keeps its reserved size
+    record_publish(header);
+    if (used > 0) {
+        logger_stat_record(logger, 0);
+    }
+    return used;
+}
+
+int logger_vlogf_deferred(LoggerHandler logger, page_type_t level, const char *fmt, va_list args)
+{
+    if (logger == NULL || fmt == NULL) {
+        return -1;
+    }
+    if (!logger_level_passes(logger, level)) {
+        LOGGER_STAT_ADD(logger, filtered, 1);
+        return 0; // Before any argument is walked
+    }
+
+    const uint32_t start = logger_stat_begin(logger);
+
+    const uint32_t cycles = logger_profile_begin();
+    int size = logger_format_packed_size(fmt, args);
+    if (size < 0) {
+        return -1; // Unsupported conversion
+    }
+
+    record_header *header = logger_reserve_head(logger, size, level);
+    if (header == NULL) {
+        LOGGER_STAT_ADD(logger, drops, 1);
+        return -1;
+    }
+    header->kind = RECORD_KIND_DEFERRED;
+    logger_format_pack((char *)(header + 1), fmt, args);
+    record_publish(header);
+    logger_stat_record(logger, start);
+    logger_profile_end(LOGGER_PROFILE_APPEND, cycles);
+    return size;
+}
+
+int logger_logf_deferred(LoggerHandler logger, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int result = logger_vlogf_deferred(logger, PAGE_TYPE_DEFAULT, fmt, args);
+    va_end(args);
+    return result;
+}
+
+int logger_logf_deferred_level(LoggerHandler logger, page_type_t level, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int result = logger_vlogf_deferred(logger, level, fmt, args);
+    va_end(args);
+    return result;
+}
+
+void logger_set_level(LoggerHandler logger, page_type_t min_level)
+{
+    if (logger == NULL) {
+        return;
+    }
+    atomic_store_explicit(&logger->min_rank, LOGFLOW_LEVEL_RANK(min_level), memory_order_relaxed);
+}
+
+int logger_level_enabled(LoggerHandler logger, page_type_t level)
+{
+    return logger != NULL && logger_level_passes(logger, level);
+}
+
+int logger_set_overflow(LoggerHandler logger, const logger_overflow_t *policy)
+{
+    if (logger == NULL) {
+        return -1;
+    }
+    int reserved = 0;
+    int debug = 0;
+    if (policy != NULL) {
+        reserved = policy->reserved_pages;
+        debug = policy->debug_pages;
+        if (reserved < 0 || debug < 0 || reserved + debug >= logger->total_pages) {
+            return -1; // Info records need at least one page of their own
         }
-        page_index--;
     }
+
+    logger_rotate_lock(logger);
+    for (int rank = 0; rank < LOGFLOW_LEVEL_NONE; rank++) {
+        int floor = rank < LOGFLOW_LEVEL_WARNING ? reserved : 0;
+        if (rank == LOGFLOW_LEVEL_DEBUG) {
+            floor += debug; // Debug runs out first
+        }
+        logger->overflow_floor[rank] = floor;
+    }
+    logger->overflow_depth = reserved + debug;
+    logger_rotate_unlock(logger);
+    return 0;
+}
+
+int logger_set_page_type(LoggerHandler logger, int page_index, page_type_t type)
+{
+    page_list *current = logger_get_page(logger, page_index);
+    if (current == NULL) {
+        return -1;
+    }
+
+    current->type = type;
+    return 0; // Success
+}
+
+char *logger_get_page_buffer(LoggerHandler logger, int page_index)
+{
+    page_list *current = logger_get_page(logger, page_index);
+    if (current == NULL) {
+        return NULL; // Page not found
+    }
+    return current->buffer; // Return the buffer of the specified page
+}
+
+int logger_page_count(LoggerHandler logger)
+{
+    return logger != NULL ? logger->total_pages : -1;
+}
+
+void logger_set_clock(LoggerHandler logger, logger_clock_fn clock)
+{
+    if (logger == NULL) {
+        return;
+    }
+    logger->clock = clock != NULL ? clock : logger_clock_us;
+}
+
+// O(1) logical reset: records of the old generation stop matching the commit tag,
+// and clearing the first byte keeps the page an empty string for strnlen() readers
+static void page_reset(LoggerHandler logger, page_list *page)
+{
+    const uint32_t cycles = logger_profile_begin();
+    const int used = page_fill(logger, page);
+    if (used > page->high_water) {
+        page->high_water = used;
+    }
+    LOGGER_STAT_ADD(logger, bytes, used); // Leaves the live sum of logger_get_stats()
+    LOGGER_STAT_ADD(logger, flushes, 1);
+
+    if (logger->flags & LOGGER_FLAG_SECURE_WIPE) {
+        memset(page->buffer, 0, logger->page_buffer_size);
+    }
+    else {
+        page->buffer[0] = '\0';
+    }
+
+    unsigned int epoch = atomic_load_explicit(&page->epoch, memory_order_relaxed) + 1;
+    if (RECORD_COMMIT_TAG(epoch) == 0) {
+        epoch++; // A zero tag would match zeroed memory
+    }
+    atomic_store_explicit(&page->epoch, epoch, memory_order_relaxed);
+    atomic_store_explicit(&page->used, 0, memory_order_relaxed); // Reset remaining space
+    atomic_store_explicit(&page->sealed, -1, memory_order_relaxed);
+    page->foreign = 0;
+    page_summary_reset(page, logger->clock());
+    atomic_store_explicit(&page->format, PAGE_FORMAT_EMPTY, memory_order_release);
+    page->type = PAGE_TYPE_DEFAULT; // Reset type
+    logger_profile_end(LOGGER_PROFILE_FLUSH, cycles);
+}
+
+void logger_flush_page(LoggerHandler logger, int page_index)
+{
+    page_list *current = logger_get_page(logger, page_index);
+    if (current == NULL) {
+        return;
+    }
+    page_reset(logger, current);
+}
+
+void logger_set_secure_wipe(LoggerHandler logger, int enable)
+{
+    if (logger == NULL) {
+        return;
+    }
+    if (enable) {
+        logger->flags |= LOGGER_FLAG_SECURE_WIPE;
+    }
+    else {
+        logger->flags &= ~LOGGER_FLAG_SECURE_WIPE;
+    }
+}
+
+// --- Statistics ---
+// Bytes written already sitting in the pages, record headers and padding included
+static unsigned long logger_live_bytes(LoggerHandler logger)
+{
+    unsigned long bytes = 0;
+    for (int i = 0; i < logger->total_pages; i++) {
+        bytes += page_fill(logger, logger->page_table[i]);
+    }
+    return bytes;
+}
+
+void logger_reset_stats(LoggerHandler logger)
+{
+    if (logger == NULL) {
+        return;
+    }
+    logger_stats_clear(&logger->stats);
+    for (int i = 0; i < logger->total_pages; i++) {
+        logger->page_table[i]->high_water = 0;
+    }
+    // Starts below zero by what the pages hold now, so only later writes count
+    atomic_store_explicit(&logger->stats.bytes, 0ul - logger_live_bytes(logger), memory_order_relaxed);
+}
+
+int logger_get_stats(LoggerHandler logger, logger_stats_t *out)
+{
+    if (logger == NULL || out == NULL) {
+        return -1;
+    }
+    const logger_stats_block *stats = &logger->stats;
+    out->bytes_written = atomic_load_explicit(&stats->bytes, memory_order_relaxed) + logger_live_bytes(logger);
+    out->records = atomic_load_explicit(&stats->records, memory_order_relaxed);
+    out->truncations = atomic_load_explicit(&stats->truncations, memory_order_relaxed);
+    out->drops = atomic_load_explicit(&stats->drops, memory_order_relaxed);
+    out->filtered = atomic_load_explicit(&stats->filtered, memory_order_relaxed);
+    out->flushes = atomic_load_explicit(&stats->flushes, memory_order_relaxed);
+    out->rotations = atomic_load_explicit(&stats->rotations, memory_order_relaxed);
+    out->shed = atomic_load_explicit(&stats->shed, memory_order_relaxed);
+    out->max_append_ns = atomic_load_explicit(&stats->max_append_ns, memory_order_relaxed);
+    return 0;
+}
+
+int logger_get_page_high_water(LoggerHandler logger, int page_index)
+{
+    page_list *page = logger_get_page(logger, page_index);
+    if (page == NULL) {
+        return -1;
+    }
+    int used = page_fill(logger, page);
+    return used > page->high_water ? used : page->high_water;
 }
 
 void logger_flush_all(LoggerHandler logger)
 {
     page_list *current, *tmp;
     list_for_each_entry_safe(current, tmp, &logger->pages.list, list) {
-        current->buffer[0] = '\0'; // Clear first byte
-        current->buffer[1] = '\0'; // Clear second byte
-        current->remaining = logger->page_buffer_size; // Reset remaining space
-        current->type = PAGE_TYPE_DEFAULT; // Reset type
+        page_reset(logger, current);
     }
+    atomic_store_explicit(&logger->head, logger->page_table[0], memory_order_release);
+    atomic_store_explicit(&logger->tail, logger->page_table[0], memory_order_release);
+    atomic_store_explicit(&logger->pending, 0, memory_order_relaxed);
+    logger_archive_clear(logger);
 }
\ No newline at end of file
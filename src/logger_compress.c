@@ -0,0 +1,408 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_compress.h"
+#include "logger_port.h"
+#include <string.h>
+
+// --- LZ codec ---
+#define LZ_MIN_MATCH 4
+#define LZ_LAST_LITERALS 5      // The block always ends with this many literals
+#define LZ_MATCH_LIMIT 12       // No match starts this close to the end
+#define LZ_MAX_OFFSET 65535
+
+static inline uint32_t lz_read32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t lz_hash(uint32_t v)
+{
+    return (v * 2654435761u) >> (32 - LOGGER_LZ_HASH_BITS);
+}
+
+static inline uint8_t *lz_put_length(uint8_t *op, int length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+static uint8_t *lz_put_sequence(uint8_t *op, const uint8_t *literals, int literal_length, int match_length)
+{
+    uint8_t *token = op++;
+    *token = (uint8_t)((literal_length >= 15 ? 15 : literal_length) << 4);
+    if (literal_length >= 15) {
+        op = lz_put_length(op, literal_length - 15);
+    }
+    memcpy(op, literals, literal_length);
+    op += literal_length;
+    if (match_length >= 0) {
+        *token |= (uint8_t)(match_length >= 15 ? 15 : match_length);
+    }
+    return op;
+}
+
+int logger_lz_compress(const char *src, int length, char *dst, int capacity, uint32_t *table)
+{
+    if (length < 0 || capacity < LOGGER_LZ_BOUND(length)) {
+        return -1;
+    }
+    const uint8_t *base = (const uint8_t *)src;
+    const uint8_t *end = base + length;
+    const uint8_t *ip = base;
+    const uint8_t *anchor = base;
+    uint8_t *op = (uint8_t *)dst;
+
+    if (length > LZ_MATCH_LIMIT) {
+        memset(table, 0, LOGGER_LZ_TABLE_SIZE * sizeof(uint32_t)); // Stale entries are verified anyway
+        const uint8_t *match_limit = end - LZ_MATCH_LIMIT;
+        const uint8_t *extend_limit = end - LZ_LAST_LITERALS;
+
+        while (ip < match_limit) {
+            const uint32_t sequence = lz_read32(ip);
+            const uint32_t h = lz_hash(sequence);
+            const uint8_t *ref = base + table[h];
+            table[h] = (uint32_t)(ip - base);
+            if (ref >= ip || ip - ref > LZ_MAX_OFFSET || lz_read32(ref) != sequence) {
+                ip++;
+                continue;
+            }
+
+            const uint8_t *mp = ip + LZ_MIN_MATCH;
+            const uint8_t *rp = ref + LZ_MIN_MATCH;
+            while (mp < extend_limit && *mp == *rp) {
+                mp++;
+                rp++;
+            }
+
+            const int match_length = (int)(mp - ip) - LZ_MIN_MATCH;
+            const int offset = (int)(ip - ref);
+            op = lz_put_sequence(op, anchor, (int)(ip - anchor), match_length);
+            *op++ = (uint8_t)offset;
+            *op++ = (uint8_t)(offset >> 8);
+            if (match_length >= 15) {
+                op = lz_put_length(op, match_length - 15);
+            }
+            ip = mp;
+            anchor = ip;
+        }
+    }
+
+    op = lz_put_sequence(op, anchor, (int)(end - anchor), -1); // Trailing literals
+    return (int)(op - (uint8_t *)dst);
+}
+
+// Reads an extended length, -1 when the input ends first
+static inline int lz_get_length(const uint8_t **ip, const uint8_t *end, int length)
+{
+    unsigned int byte;
+    do {
+        if (*ip >= end) {
+            return -1;
+        }
+        byte = *(*ip)++;
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+int logger_lz_decompress(const char *src, int length, char *dst, int capacity)
+{
+    const uint8_t *ip = (const uint8_t *)src;
+    const uint8_t *end = ip + length;
+    uint8_t *op = (uint8_t *)dst;
+    uint8_t *out_end = op + capacity;
+
+    while (ip < end) {
+        const unsigned int token = *ip++;
+        int literal_length = token >> 4;
+        if (literal_length == 15 && (literal_length = lz_get_length(&ip, end, literal_length)) < 0) {
+            return -1;
+        }
+        if (end - ip < literal_length || out_end - op < literal_length) {
+            return -1;
+        }
+        memcpy(op, ip, literal_length);
+        op += literal_length;
+        ip += literal_length;
+        if (ip == end) {
+            break; // Last sequence has no match
+        }
+
+        if (end - ip < 2) {
+            return -1;
+        }
+        const int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op - (uint8_t *)dst) {
+            return -1;
+        }
+        int match_length = token & 15;
+        if (match_length == 15 && (match_length = lz_get_length(&ip, end, match_length)) < 0) {
+            return -1;
+        }
+        match_length += LZ_MIN_MATCH;
+        if (out_end - op < match_length) {
+            return -1;
+        }
+        const uint8_t *ref = op - offset;
+        while (match_length--) {
+            *op++ = *ref++; // Byte by byte, matches may overlap their own output
+        }
+    }
+    return (int)(op - (uint8_t *)dst);
+}
+
+// --- Archive of compressed pages ---
+// Entries follow each other in a circular pool and may wrap around its end
+
+_Static_assert(LOGGER_DECODER_ARCHIVE_SIZE(4096)
+               == 4 + LOGGER_LZ_BOUND(LOGGER_ARCHIVE_RAW_SIZE(4096)) + LOGGER_ARCHIVE_RAW_SIZE(4096),
+               "LOGGER_DECODER_ARCHIVE_SIZE out of sync with the archive entry bounds");
+
+struct logger_archive {
+    char *pool;
+    int capacity;
+    int start;                  // Offset of the oldest entry
+    int used;
+    int count;
+    char *raw;                  // Page serialized into export frames
+    int raw_capacity;
+    char *packed;               // Compressor output before it is copied into the pool
+    int packed_capacity;
+    uint32_t table[LOGGER_LZ_TABLE_SIZE];
+    atomic_int staged;          // stage waits for logger_archive_commit(), raw and packed are in use
+    page_list stage;            // Copy of the page taken at rotation, its buffer follows packed
+    int stage_index;
+};
+
+static void pool_write(struct logger_archive *archive, int offset, const void *data, int length)
+{
+    offset %= archive->capacity;
+    int first = archive->capacity - offset < length ? archive->capacity - offset : length;
+    memcpy(archive->pool + offset, data, first);
+    memcpy(archive->pool, (const char *)data + first, length - first);
+}
+
+static void pool_read(const struct logger_archive *archive, int offset, void *data, int length)
+{
+    offset %= archive->capacity;
+    int first = archive->capacity - offset < length ? archive->capacity - offset : length;
+    memcpy(data, archive->pool + offset, first);
+    memcpy((char *)data + first, archive->pool, length - first);
+}
+
+static void archive_drop_oldest(struct logger_archive *archive)
+{
+    uint32_t packed;
+    pool_read(archive, archive->start, &packed, sizeof(packed));
+    const int entry = LOGGER_ARCHIVE_ENTRY_HEADER + (int)packed;
+    archive->start = (archive->start + entry) % archive->capacity;
+    archive->used -= entry;
+    archive->count--;
+}
+
+int logger_set_compression(LoggerHandler logger, int pool_size)
+{
+    if (logger == NULL || pool_size < 0) {
+        return -1;
+    }
+
+    struct logger_archive *archive = NULL;
+    if (pool_size > 0) {
+        const int raw_capacity = LOGGER_ARCHIVE_RAW_SIZE(logger->page_buffer_size);
+        const int packed_capacity = LOGGER_LZ_BOUND(raw_capacity);
+        archive = mallocv(sizeof(struct logger_archive) + pool_size + raw_capacity + packed_capacity
+                          + logger->page_buffer_size);
+        if (archive == NULL) {
+            return -1;
+        }
+        archive->pool = (char *)(archive + 1);
+        archive->capacity = pool_size;
+        archive->start = 0;
+        archive->used = 0;
+        archive->count = 0;
+        archive->raw = archive->pool + pool_size;
+        archive->raw_capacity = raw_capacity;
+        archive->packed = archive->raw + raw_capacity;
+        archive->packed_capacity = packed_capacity;
+        archive->stage.buffer = archive->packed + packed_capacity;
+        atomic_init(&archive->staged, 0);
+    }
+
+    logger_rotate_lock(logger); // Rotations and snapshots only touch the archive under the lock
+    struct logger_archive *old = logger->archive;
+    logger->archive = archive;
+    logger_rotate_unlock(logger);
+    if (old != NULL) {
+        while (atomic_load_explicit(&old->staged, memory_order_acquire)) {
+            logger_sleep_ms(1); // A producer still compresses into it
+        }
+        freev(old);
+    }
+    return 0;
+}
+
+int logger_archive_busy(LoggerHandler logger)
+{
+    return logger->archive != NULL && atomic_load_explicit(&logger->archive->staged, memory_order_acquire);
+}
+
+struct logger_archive *logger_archive_stage(LoggerHandler logger, page_list *page)
+{
+    struct logger_archive *archive = logger->archive;
+    if (archive == NULL
+        || (atomic_load_explicit(&page->format, memory_order_acquire) == PAGE_FORMAT_EMPTY
+            && page_text_length(logger, page) == 0)) {
+        return NULL;
+    }
+
+    page_wait_settled(page);
+    // A plain copy is all the lock is held for, the page is reset right after
+    char *buffer = archive->stage.buffer;
+    memcpy(&archive->stage, page, sizeof(page_list));
+    archive->stage.buffer = buffer;
+    memcpy(buffer, page->buffer, logger->page_buffer_size);
+    archive->stage_index = logger_page_index(logger, page);
+    atomic_store_explicit(&archive->staged, 1, memory_order_relaxed);
+    return archive;
+}
+
+void logger_archive_commit(LoggerHandler logger, struct logger_archive *archive)
+{
+    const int raw = logger_export_serialize(logger, &archive->stage, archive->stage_index,
+                                            archive->raw, archive->raw_capacity);
+    const int packed = raw > 0 ? logger_lz_compress(archive->raw, raw, archive->packed, archive->packed_capacity,
+                                                    archive->table) : -1;
+    const int entry = LOGGER_ARCHIVE_ENTRY_HEADER + packed;
+
+    logger_rotate_lock(logger); // Snapshots read the pool under the lock
+    if (packed >= 0 && entry <= archive->capacity) { // Otherwise the pool is too small for even one page
+        while (archive->capacity - archive->used < entry) {
+            archive_drop_oldest(archive);
+        }
+        const uint32_t header[2] = { (uint32_t)packed, (uint32_t)raw };
+        const int offset = archive->start + archive->used;
+        pool_write(archive, offset, header, sizeof(header));
+        pool_write(archive, offset + LOGGER_ARCHIVE_ENTRY_HEADER, archive->packed, packed);
+        archive->used += entry;
+        archive->count++;
+    }
+    atomic_store_explicit(&archive->staged, 0, memory_order_release);
+    logger_rotate_unlock(logger);
+}
+
+void logger_archive_clear(LoggerHandler logger)
+{
+    struct logger_archive *archive = logger->archive;
+    if (archive != NULL) {
+        archive->start = 0;
+        archive->used = 0;
+        archive->count = 0;
+    }
+}
+
+void logger_archive_free(LoggerHandler logger)
+{
+    if (logger->archive != NULL) {
+        freev(logger->archive);
+        logger->archive = NULL;
+    }
+}
+
+char *logger_archive_snapshot(LoggerHandler logger, int *length)
+{
+    *length = 0;
+    logger_rotate_lock(logger);
+    struct logger_archive *archive = logger->archive;
+    char *copy = NULL;
+    if (archive != NULL && archive->used > 0) {
+        copy = mallocv(archive->used);
+        if (copy != NULL) {
+            pool_read(archive, archive->start, copy, archive->used);
+            *length = archive->used;
+        }
+    }
+    logger_rotate_unlock(logger);
+    return copy;
+}
+
+// --- Archive readout ---
+typedef struct {
+    logger_out *out;
+    uint32_t level_mask;
+    int prefix_text;            // Text pages start with their level, as logger_print_filtered() does
+    int text_visible;           // Text of the current page passes the filter
+} archive_print_ctx;
+
+static void archive_print_item(void *ctx, const logger_export_item_t *item)
+{
+    archive_print_ctx *print = ctx;
+    switch (item->event) {
+        case LOGGER_EXPORT_PAGE:
+            print->text_visible = (print->level_mask & LOGGER_LEVEL_MASK(item->type)) != 0;
+            if (print->text_visible && !item->is_record && print->prefix_text) {
+                logger_out_puts(print->out, logger_print_start_message_section(item->type));
+            }
+            break;
+        case LOGGER_EXPORT_TEXT:
+            if (print->text_visible) {
+                logger_out_write(print->out, item->data, item->length);
+            }
+            break;
+        case LOGGER_EXPORT_RECORD:
+            if (print->level_mask & LOGGER_LEVEL_MASK(item->type)) {
+                logger_out_printf(print->out, "[%lu] ", (unsigned long)item->timestamp);
+                logger_out_puts(print->out, logger_print_start_message_section(item->type));
+                logger_out_write(print->out, item->data, item->length);
+                logger_out_write(print->out, "\n", 1);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void logger_archive_print(logger_out *out, LoggerHandler logger, uint32_t level_mask, int framed)
+{
+    int length;
+    char *entries = logger_archive_snapshot(logger, &length);
+    if (entries == NULL) {
+        return;
+    }
+    char *raw = mallocv(LOGGER_ARCHIVE_RAW_SIZE(logger->page_buffer_size));
+    if (raw == NULL) {
+        freev(entries);
+        return;
+    }
+
+    archive_print_ctx ctx = { out, level_mask, !framed, 0 };
+    logger_decoder_t decoder;
+    logger_decoder_init(&decoder, NULL, 0, archive_print_item, &ctx);
+    decoder.version = LOGGER_EXPORT_VERSION; // Frames come from this build, no stream header
+
+    for (int offset = 0; offset + LOGGER_ARCHIVE_ENTRY_HEADER <= length; ) {
+        uint32_t header[2];
+        memcpy(header, entries + offset, sizeof(header));
+        const int n = logger_lz_decompress(entries + offset + LOGGER_ARCHIVE_ENTRY_HEADER, (int)header[0],
+                                           raw, LOGGER_ARCHIVE_RAW_SIZE(logger->page_buffer_size));
+        offset += LOGGER_ARCHIVE_ENTRY_HEADER + (int)header[0];
+        if (n < 0) {
+            continue;
+        }
+        if (framed) {
+            logger_out_puts(out, "archived---[");
+        }
+        logger_decoder_frames(&decoder, raw, n);
+        if (framed) {
+            logger_out_puts(out, "]---\n");
+        }
+    }
+    freev(raw);
+    freev(entries);
+}
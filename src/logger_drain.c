@@ -0,0 +1,277 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_port.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// --- Background drain worker ---
+// Pages filled by logger_write() and friends queue up between logger->tail and
+// logger->head. The worker writes them to the logger's sink outside of any
+// producer path, so producers keep appending to fresh pages and never wait on I/O.
+// One worker may serve several loggers, e.g. every member of a logger group.
+
+#define DRAIN_SYNC_POLL_MS 10
+
+struct logger_drain {
+    logger_drain_config_t config;
+    logger_thread_t thread;
+    logger_sem_t wake;          // Posted by producers and logger_drain_sync()
+    logger_sem_t idle;          // Posted after each pass while someone waits in logger_drain_sync()
+    logger_sem_t members_lock;  // Used as a mutex, held by every pass and while members change
+    atomic_bool stop;
+    atomic_int drain_all;       // Sync requests: ignore the low watermark
+    atomic_int waiters;
+    int shared;                 // Outlives its members, logger_drain_stop() only detaches them
+    int count;
+    int capacity;
+    LoggerHandler members[];
+};
+
+void logger_drain_notify(LoggerHandler logger, int pending)
+{
+    struct logger_drain *drain = logger->drain;
+    if (drain != NULL && pending >= drain->config.high_watermark) {
+        logger_sem_post(&drain->wake);
+    }
+}
+
+void LOGGER_ISR_ATTR logger_drain_notify_isr(LoggerHandler logger)
+{
+    struct logger_drain *drain = logger->drain;
+    if (drain != NULL) {
+        logger_sem_post_isr(&drain->wake);
+    }
+}
+
+// Writes out the oldest full page, returns 0 when nothing is pending
+static int drain_one(LoggerHandler logger)
+{
+    logger_rotate_lock(logger);
+    page_list *page = atomic_load_explicit(&logger->tail, memory_order_relaxed);
+    if (page == atomic_load_explicit(&logger->head, memory_order_relaxed)) {
+        logger_rotate_unlock(logger);
+        return 0;
+    }
+    logger->draining = page; // Producers may not overwrite it from now on
+    logger_rotate_unlock(logger);
+
+    page_wait_settled(page);
+
+    logger_out out;
+    logger_out_init(&out, logger);
+    if (logger->drain->config.format == LOGGER_FORMAT_FRAMES) {
+        logger_export_stream_page(&out, logger, page);
+    }
+    else {
+        logger_print_content(&out, logger, page);
+    }
+    logger_out_end(&out);
+
+    logger_rotate_lock(logger);
+    atomic_store_explicit(&logger->tail, page_next(logger, page), memory_order_relaxed);
+    atomic_fetch_sub_explicit(&logger->pending, 1, memory_order_relaxed);
+    logger->draining = NULL;
+    logger_rotate_unlock(logger);
+    return 1;
+}
+
+static void drain_pass(struct logger_drain *drain)
+{
+    const int target = atomic_load(&drain->drain_all) > 0 ? 0 : drain->config.low_watermark;
+    logger_sem_wait(&drain->members_lock, -1);
+    for (int i = 0; i < drain->count; i++) {
+        LoggerHandler logger = drain->members[i];
+        if (logger->isr != NULL) {
+            logger_isr_merge(logger); // Interrupt records join the pages first
+        }
+        while (atomic_load_explicit(&logger->pending, memory_order_relaxed) > target) {
+            if (!drain_one(logger)) {
+                break;
+            }
+        }
+    }
+    logger_sem_post(&drain->members_lock);
+    if (atomic_load(&drain->waiters) > 0) {
+        logger_sem_post(&drain->idle);
+    }
+}
+
+static void drain_worker(void *arg)
+{
+    struct logger_drain *drain = arg;
+    const int timeout = drain->config.interval_ms > 0 ? drain->config.interval_ms : -1;
+
+    while (!atomic_load(&drain->stop)) {
+        logger_sem_wait(&drain->wake, timeout);
+        drain_pass(drain);
+    }
+
+    atomic_fetch_add(&drain->drain_all, 1);
+    drain_pass(drain); // Whatever filled up while stopping
+}
+
+struct logger_drain *logger_drain_open(const logger_drain_config_t *config, int capacity, int shared)
+{
+    struct logger_drain *drain = mallocv(sizeof(struct logger_drain) + capacity * sizeof(LoggerHandler));
+    if (drain == NULL) {
+        return NULL;
+    }
+
+    const logger_drain_config_t defaults = LOGGER_DRAIN_CONFIG_DEFAULT;
+    drain->config = config != NULL ? *config : defaults;
+    if (drain->config.high_watermark < 1) {
+        drain->config.high_watermark = 1;
+    }
+    if (drain->config.low_watermark < 0 || drain->config.low_watermark >= drain->config.high_watermark) {
+        drain->config.low_watermark = 0;
+    }
+    atomic_init(&drain->stop, false);
+    atomic_init(&drain->drain_all, 0);
+    atomic_init(&drain->waiters, 0);
+    drain->shared = shared;
+    drain->count = 0;
+    drain->capacity = capacity;
+
+    if (logger_sem_init(&drain->wake) != 0) {
+        freev(drain);
+        return NULL;
+    }
+    if (logger_sem_init(&drain->idle) != 0) {
+        logger_sem_destroy(&drain->wake);
+        freev(drain);
+        return NULL;
+    }
+    if (logger_sem_init(&drain->members_lock) != 0) {
+        logger_sem_destroy(&drain->idle);
+        logger_sem_destroy(&drain->wake);
+        freev(drain);
+        return NULL;
+    }
+    logger_sem_post(&drain->members_lock);
+
+    if (logger_thread_start(&drain->thread, drain_worker, drain, "logflow_drain",
+                            drain->config.stack_size, drain->config.priority) != 0) {
+        logger_sem_destroy(&drain->members_lock);
+        logger_sem_destroy(&drain->idle);
+        logger_sem_destroy(&drain->wake);
+        freev(drain);
+        return NULL;
+    }
+    return drain;
+}
+
+int logger_drain_attach(struct logger_drain *drain, LoggerHandler logger)
+{
+    if (logger->drain != NULL || logger->total_pages < 2) {
+        return -1; // Double buffering needs a second page
+    }
+    logger_sem_wait(&drain->members_lock, -1);
+    if (drain->count == drain->capacity) {
+        logger_sem_post(&drain->members_lock);
+        return -1;
+    }
+    // Rotation starts queueing pages for the worker right away
+    logger_rotate_lock(logger);
+    atomic_store_explicit(&logger->tail, atomic_load_explicit(&logger->head, memory_order_relaxed), memory_order_relaxed);
+    atomic_store_explicit(&logger->pending, 0, memory_order_relaxed);
+    logger->drain = drain;
+    logger_rotate_unlock(logger);
+    drain->members[drain->count++] = logger;
+    logger_sem_post(&drain->members_lock);
+    return 0;
+}
+
+static void drain_detach(struct logger_drain *drain, LoggerHandler logger)
+{
+    logger_sem_wait(&drain->members_lock, -1);
+    for (int i = 0; i < drain->count; i++) {
+        if (drain->members[i] == logger) {
+            drain->members[i] = drain->members[--drain->count];
+            break;
+        }
+    }
+    logger_rotate_lock(logger);
+    logger->drain = NULL;
+    logger_rotate_unlock(logger);
+    logger_sem_post(&drain->members_lock);
+}
+
+void logger_drain_close(struct logger_drain *drain)
+{
+    atomic_store(&drain->stop, true);
+    logger_sem_post(&drain->wake);
+    logger_thread_join(&drain->thread); // Its last pass writes out the members still attached
+
+    while (drain->count > 0) {
+        drain_detach(drain, drain->members[0]);
+    }
+    logger_sem_destroy(&drain->members_lock);
+    logger_sem_destroy(&drain->idle);
+    logger_sem_destroy(&drain->wake);
+    freev(drain);
+}
+
+int logger_drain_start(LoggerHandler logger, const logger_drain_config_t *config)
+{
+    if (logger == NULL || logger->drain != NULL || logger->total_pages < 2) {
+        return -1;
+    }
+    struct logger_drain *drain = logger_drain_open(config, 1, 0);
+    if (drain == NULL) {
+        return -1;
+    }
+    if (logger_drain_attach(drain, logger) != 0) {
+        logger_drain_close(drain);
+        return -1;
+    }
+    return 0;
+}
+
+int logger_drain_sync(LoggerHandler logger)
+{
+    if (logger == NULL || logger->drain == NULL) {
+        return -1;
+    }
+    struct logger_drain *drain = logger->drain;
+
+    atomic_fetch_add(&drain->drain_all, 1);
+    atomic_fetch_add(&drain->waiters, 1);
+    if (logger->isr != NULL) {
+        logger_isr_merge(logger); // Before the head is queued, so they are part of this sync
+    }
+
+    // Queue the partly filled head page too, then wait until the worker caught up
+    page_list *head = atomic_load_explicit(&logger->head, memory_order_acquire);
+    int head_queued = atomic_load_explicit(&head->used, memory_order_relaxed) == 0;
+    for (;;) {
+        if (!head_queued) {
+            head_queued = logger_rotate(logger, head, PAGE_TYPE_ERROR) == 0
+                || atomic_load_explicit(&logger->head, memory_order_acquire) != head;
+        }
+        if (head_queued && atomic_load_explicit(&logger->pending, memory_order_relaxed) == 0) {
+            break;
+        }
+        logger_sem_post(&drain->wake);
+        logger_sem_wait(&drain->idle, DRAIN_SYNC_POLL_MS);
+    }
+
+    atomic_fetch_sub(&drain->waiters, 1);
+    atomic_fetch_sub(&drain->drain_all, 1);
+    return 0;
+}
+
+void logger_drain_stop(LoggerHandler logger)
+{
+    if (logger == NULL || logger->drain == NULL) {
+        return;
+    }
+    struct logger_drain *drain = logger->drain;
+
+    logger_drain_sync(logger);
+    if (drain->shared) {
+        drain_detach(drain, logger); // The worker goes on for the other members
+    }
+    else {
+        logger_drain_close(drain);
+    }
+}
@@ -0,0 +1,621 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_format.h"
+#include "logger_compress.h"
+#include "logger_port.h"
+#include <stdatomic.h>
+#include <string.h>
+
+// --- Binary export ---
+// The stream is a sequence of frames: [u8 tag][u32 length][payload], little-endian.
+// Only used bytes go out: text pages up to their write offset, record pages as
+// one frame per committed record with deferred formats rendered on the way.
+// Unknown tags can be skipped by length, which is how later versions extend it.
+// Record timestamps are zigzag varints of the difference to the previous record of
+// the page, the first one to 0, so a record usually costs two bytes besides its
+// frame header. Version 1 streams carried a u32 timestamp and a reserved byte.
+//
+//   'H' header   u16 version, u16 reserved, u32 page_size, u32 page_count, u32 flags
+//   'P' page     u32 index, i8 type, u8 format
+//   'T' text     raw bytes of the page above, split in chunks of LOGGER_EXPORT_CHUNK
+//   'R' record   varint timestamp delta, i8 level, payload
+//   'Z' archive  u32 raw length, LZ-compressed 'P', 'T' and 'R' frames of one page
+//   'E' end      u32 CRC-32 of every byte before this frame
+//   'C' context  u16 version, u32 index, i8 type, u8 format, u32 timestamp of the last
+//                record; lets a datagram start mid-page, left out of the CRC
+
+#define EXPORT_FRAME_HEADER 5
+#define EXPORT_RECORD_HEADER_V1 6
+#define EXPORT_VARINT_MAX 5         // Bytes of a 32-bit varint
+#define EXPORT_FLAG_RING 1u
+
+enum {
+    FRAME_HEADER = 'H',
+    FRAME_PAGE = 'P',
+    FRAME_TEXT = 'T',
+    FRAME_RECORD = 'R',
+    FRAME_ARCHIVE = 'Z',
+    FRAME_END = 'E',
+    FRAME_CONTEXT = 'C'
+};
+
+typedef struct {
+    const logger_sink_t *sink;  // Destination given to logger_export()
+    uint32_t crc;
+    int total;
+    int failed;
+} export_state;
+
+static inline void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Zigzag folds the sign into bit 0, records reserved concurrently may be out of order
+static int put_delta(uint8_t *p, uint32_t timestamp, uint32_t previous)
+{
+    const int32_t delta = (int32_t)(timestamp - previous);
+    uint32_t v = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    int n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+// Returns the bytes read, 0 when the varint does not end within length
+static int get_delta(const uint8_t *p, int length, uint32_t *timestamp)
+{
+    uint32_t v = 0;
+    for (int n = 0; n < length && n < EXPORT_VARINT_MAX; n++) {
+        v |= (uint32_t)(p[n] & 0x7F) << (7 * n);
+        if (!(p[n] & 0x80)) {
+            *timestamp += (v >> 1) ^ (0u - (v & 1));
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+// Sink seen by the logger_out staging buffer, checksums and counts everything
+static int export_write(void *ctx, const char *data, int length)
+{
+    export_state *state = ctx;
+    state->crc = logger_crc32(state->crc, data, length);
+    state->total += length;
+    if (state->sink->write(state->sink->ctx, data, length) < 0) {
+        state->failed = 1;
+    }
+    return length;
+}
+
+static void export_frame(logger_out *out, char tag, int length)
+{
+    uint8_t frame[EXPORT_FRAME_HEADER];
+    frame[0] = (uint8_t)tag;
+    put_u32(frame + 1, (uint32_t)length);
+    logger_out_write(out, (const char *)frame, sizeof(frame));
+}
+
+static void export_count(void *ctx, const char *data, int length)
+{
+    (void)data;
+    *(int *)ctx += length;
+}
+
+static void export_header(logger_out *out, int page_size, int page_count, uint32_t flags)
+{
+    uint8_t payload[16];
+    put_u16(payload, LOGGER_EXPORT_VERSION);
+    put_u16(payload + 2, 0);
+    put_u32(payload + 4, (uint32_t)page_size);
+    put_u32(payload + 8, (uint32_t)page_count);
+    put_u32(payload + 12, flags);
+    export_frame(out, FRAME_HEADER, sizeof(payload));
+    logger_out_write(out, (const char *)payload, sizeof(payload));
+}
+
+static void export_page(logger_out *out, int index, page_type_t type, page_format_t format)
+{
+    uint8_t payload[6];
+    put_u32(payload, (uint32_t)index);
+    payload[4] = (uint8_t)(int8_t)type;
+    payload[5] = (uint8_t)format;
+    export_frame(out, FRAME_PAGE, sizeof(payload));
+    logger_out_write(out, (const char *)payload, sizeof(payload));
+}
+
+// *previous holds the timestamp of the record exported before on the same page
+static void export_record(logger_out *out, const page_list *page, const record_header *record, uint32_t *previous)
+{
+    int length = record->length;
+    if (record->kind == RECORD_KIND_DEFERRED) {
+        // Frames are length-prefixed, so render once to measure
+        length = 0;
+        logger_record_render(page, record, export_count, &length);
+    }
+    char unknown[LOGGER_TAG_UNKNOWN_SIZE];
+    const char *tag = NULL;
+    int tag_length = 0;
+    if (record->kind == RECORD_KIND_TAGGED) {
+        tag_length = logger_tag_text(record->tag, unknown, &tag); // Expanded, receivers need no registry
+        length += tag_length + 2;
+    }
+
+    uint8_t payload[EXPORT_VARINT_MAX + 1];
+    int n = put_delta(payload, record->timestamp, *previous);
+    payload[n++] = (uint8_t)record->level;
+    *previous = record->timestamp;
+    export_frame(out, FRAME_RECORD, n + length);
+    logger_out_write(out, (const char *)payload, n);
+
+    if (record->kind == RECORD_KIND_DEFERRED) {
+        logger_record_render(page, record, logger_out_emit, out);
+        return;
+    }
+    if (tag != NULL) {
+        logger_out_write(out, tag, tag_length);
+        logger_out_write(out, ": ", 2);
+    }
+    logger_out_write(out, RECORD_DATA(record), record->length);
+}
+
+static void export_end(logger_out *out, export_state *state)
+{
+    logger_out_flush(out); // The CRC covers exactly what went out before this frame
+    uint8_t payload[4];
+    put_u32(payload, state->crc);
+    export_frame(out, FRAME_END, sizeof(payload));
+    logger_out_write(out, (const char *)payload, sizeof(payload));
+    logger_out_flush(out);
+    if (state->sink->flush != NULL) {
+        state->sink->flush(state->sink->ctx);
+    }
+}
+
+static void export_page_content(logger_out *out, LoggerHandler logger, page_list *page, int index)
+{
+    unsigned char format = atomic_load_explicit(&page->format, memory_order_acquire);
+    if (format == PAGE_FORMAT_RECORD) {
+        export_page(out, index, page->type, PAGE_FORMAT_RECORD);
+        int offset = 0;
+        uint32_t previous = 0;
+        const record_header *record;
+        while ((record = page_next_record(logger, page, &offset)) != NULL) {
+            export_record(out, page, record, &previous);
+        }
+        return;
+    }
+
+    int length = page_text_length(logger, page);
+    if (length == 0) {
+        return; // Nothing worth sending
+    }
+    export_page(out, index, page->type, PAGE_FORMAT_TEXT);
+    for (int offset = 0; offset < length; offset += LOGGER_EXPORT_CHUNK) {
+        int chunk = length - offset < LOGGER_EXPORT_CHUNK ? length - offset : LOGGER_EXPORT_CHUNK;
+        export_frame(out, FRAME_TEXT, chunk);
+        logger_out_write(out, page->buffer + offset, chunk);
+    }
+}
+
+void logger_export_stream_page(logger_out *out, LoggerHandler logger, page_list *page)
+{
+    const uint32_t cycles = logger_profile_begin();
+    export_header(out, logger->page_buffer_size, logger->total_pages,
+                  (logger->flags & LOGGER_FLAG_RING) ? EXPORT_FLAG_RING : 0);
+    export_page_content(out, logger, page, logger_page_index(logger, page));
+    logger_profile_end(LOGGER_PROFILE_PRINT, cycles);
+}
+
+// --- Stream context, for receivers joining mid-page ---
+void logger_export_context_track(logger_export_context *context, const char *frame, int length)
+{
+    const uint8_t *bytes = (const uint8_t *)frame;
+    const uint8_t *payload = bytes + EXPORT_FRAME_HEADER;
+    const int size = length - EXPORT_FRAME_HEADER;
+    switch (bytes[0]) {
+        case FRAME_HEADER:
+            if (size >= 16) {
+                context->version = (uint16_t)(payload[0] | (payload[1] << 8));
+                context->format = PAGE_FORMAT_EMPTY;
+            }
+            break;
+        case FRAME_PAGE:
+            if (size >= 6) {
+                context->page_index = get_u32(payload);
+                context->type = (int8_t)payload[4];
+                context->format = payload[5];
+                context->timestamp = 0;
+            }
+            break;
+        case FRAME_RECORD:
+            if (context->version == 1 && size >= EXPORT_RECORD_HEADER_V1) {
+                context->timestamp = get_u32(payload);
+            }
+            else if (context->version > 1) {
+                get_delta(payload, size, &context->timestamp);
+            }
+            break;
+        case FRAME_ARCHIVE:
+            context->format = PAGE_FORMAT_EMPTY; // Carries its own page frame
+            break;
+        case FRAME_END:
+            memset(context, 0, sizeof(*context));
+            break;
+        default:
+            break;
+    }
+}
+
+int logger_export_context_frame(const logger_export_context *context, char *out)
+{
+    if (context->version == 0) {
+        return 0;
+    }
+    uint8_t *bytes = (uint8_t *)out;
+    bytes[0] = FRAME_CONTEXT;
+    put_u32(bytes + 1, LOGGER_EXPORT_CONTEXT_SIZE - EXPORT_FRAME_HEADER);
+    put_u16(bytes + 5, context->version);
+    put_u32(bytes + 7, context->page_index);
+    bytes[11] = (uint8_t)context->type;
+    bytes[12] = context->format;
+    put_u32(bytes + 13, context->timestamp);
+    return LOGGER_EXPORT_CONTEXT_SIZE;
+}
+
+// --- Serialization into memory, input of the compressor ---
+typedef struct {
+    char *data;
+    int capacity;
+    int length;
+} memory_sink;
+
+static int memory_sink_write(void *ctx, const char *data, int length)
+{
+    memory_sink *memory = ctx;
+    int n = memory->capacity - memory->length < length ? memory->capacity - memory->length : length;
+    memcpy(memory->data + memory->length, data, n);
+    memory->length += n;
+    return length;
+}
+
+int logger_export_serialize(LoggerHandler logger, page_list *page, int index, char *dst, int capacity)
+{
+    memory_sink memory = { dst, capacity, 0 };
+    logger_sink_t sink = { memory_sink_write, &memory, NULL };
+    logger_out out;
+    out.sink = &sink;
+    out.length = 0;
+    export_page_content(&out, logger, page, index);
+    logger_out_flush(&out);
+    return memory.length;
+}
+
+static void export_archive(logger_out *out, uint32_t raw_length, const char *packed, int packed_length)
+{
+    uint8_t payload[4];
+    put_u32(payload, raw_length);
+    export_frame(out, FRAME_ARCHIVE, sizeof(payload) + packed_length);
+    logger_out_write(out, (const char *)payload, sizeof(payload));
+    logger_out_write(out, packed, packed_length);
+}
+
+// Pages kept by logger_set_compression(), already compressed, oldest first
+static void export_archived(logger_out *out, LoggerHandler logger)
+{
+    int length;
+    char *entries = logger_archive_snapshot(logger, &length);
+    if (entries == NULL) {
+        return;
+    }
+    for (int offset = 0; offset + LOGGER_ARCHIVE_ENTRY_HEADER <= length; ) {
+        uint32_t header[2]; // Compressed length, raw length
+        memcpy(header, entries + offset, sizeof(header));
+        export_archive(out, header[1], entries + offset + LOGGER_ARCHIVE_ENTRY_HEADER, (int)header[0]);
+        offset += LOGGER_ARCHIVE_ENTRY_HEADER + (int)header[0];
+    }
+    freev(entries);
+}
+
+// Live page compressed like archived ones, sent as is when that does not pay off
+static void export_page_compressed(logger_out *out, LoggerHandler logger, page_list *page, char *scratch)
+{
+    const int raw_capacity = LOGGER_ARCHIVE_RAW_SIZE(logger->page_buffer_size);
+    char *raw = scratch;
+    char *packed = raw + raw_capacity;
+    uint32_t *table = (uint32_t *)(packed + ALIGN_PTR(LOGGER_LZ_BOUND(raw_capacity), sizeof(uint32_t)));
+
+    const int length = logger_export_serialize(logger, page, logger_page_index(logger, page), raw, raw_capacity);
+    if (length <= 0) {
+        return;
+    }
+    const int packed_length = logger_lz_compress(raw, length, packed, LOGGER_LZ_BOUND(raw_capacity), table);
+    if (packed_length < 0 || packed_length + EXPORT_FRAME_HEADER + 4 >= length) {
+        logger_out_write(out, raw, length);
+    }
+    else {
+        export_archive(out, (uint32_t)length, packed, packed_length);
+    }
+}
+
+int logger_export(LoggerHandler logger, const logger_sink_t *sink)
+{
+    if (logger == NULL) {
+        return -1;
+    }
+    if (sink == NULL || sink->write == NULL) {
+        sink = &logger->sink;
+    }
+
+    export_state state = { sink, 0, 0, 0 };
+    logger_sink_t wrapped = { export_write, &state, NULL };
+    logger_out out;
+    out.sink = &wrapped;
+    out.length = 0;
+
+    export_header(&out, logger->page_buffer_size, logger->total_pages,
+                  (logger->flags & LOGGER_FLAG_RING) ? EXPORT_FLAG_RING : 0);
+
+    // With compression on, live pages go out compressed after the archived ones
+    char *scratch = NULL;
+    if (logger->archive != NULL) {
+        const int raw_capacity = LOGGER_ARCHIVE_RAW_SIZE(logger->page_buffer_size);
+        export_archived(&out, logger);
+        scratch = mallocv(raw_capacity + ALIGN_PTR(LOGGER_LZ_BOUND(raw_capacity), sizeof(uint32_t))
+                          + LOGGER_LZ_TABLE_SIZE * sizeof(uint32_t));
+    }
+
+    page_list *first = logger_oldest_page(logger);
+    page_list *current = first;
+    do {
+        if (scratch != NULL) {
+            export_page_compressed(&out, logger, current, scratch);
+        }
+        else {
+            export_page_content(&out, logger, current, logger_page_index(logger, current));
+        }
+        current = page_next(logger, current);
+    } while (current != first);
+    if (scratch != NULL) {
+        freev(scratch);
+    }
+
+    export_end(&out, &state);
+    return state.failed ? -1 : state.total;
+}
+
+// --- Sharded export, records merged by timestamp ---
+typedef struct {
+    logger_out *out;
+    int last;                   // Shard of the previous record, a 'P' frame marks every switch
+    uint32_t previous;          // Timestamp of the previous record since that frame
+} shard_export_ctx;
+
+static void shard_export_one(void *ctx, int shard, const page_list *page, const record_header *record)
+{
+    shard_export_ctx *export = ctx;
+    if (shard != export->last) {
+        export_page(export->out, shard, PAGE_TYPE_DEFAULT, PAGE_FORMAT_RECORD);
+        export->last = shard;
+        export->previous = 0;
+    }
+    export_record(export->out, page, record, &export->previous);
+}
+
+int logger_shards_export(LoggerShardsHandler shards, const logger_sink_t *sink)
+{
+    if (shards == NULL) {
+        return -1;
+    }
+    LoggerHandler first = logger_shards_get(shards, 0);
+    if (sink == NULL || sink->write == NULL) {
+        sink = &first->sink;
+    }
+
+    export_state state = { sink, 0, 0, 0 };
+    logger_sink_t wrapped = { export_write, &state, NULL };
+    logger_out out;
+    out.sink = &wrapped;
+    out.length = 0;
+
+    // Page indexes of a merged stream name the shard a record came from
+    export_header(&out, first->page_buffer_size, logger_shards_count(shards), 0);
+    shard_export_ctx ctx = { &out, -1, 0 };
+    logger_shards_merge(shards, LOGGER_LEVEL_ALL, shard_export_one, &ctx);
+    export_end(&out, &state);
+    return state.failed ? -1 : state.total;
+}
+
+// --- Streaming decoder ---
+void logger_decoder_init(logger_decoder_t *decoder, char *buffer, int capacity,
+                         logger_export_fn callback, void *ctx)
+{
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->buffer = buffer;
+    decoder->capacity = capacity;
+    decoder->callback = callback;
+    decoder->ctx = ctx;
+}
+
+static int decoder_frame(logger_decoder_t *decoder, char tag, const uint8_t *payload, int length);
+
+int logger_decoder_frames(logger_decoder_t *decoder, const char *data, int length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (int offset = 0; offset + EXPORT_FRAME_HEADER <= length; ) {
+        const char tag = (char)bytes[offset];
+        const uint32_t size = get_u32(bytes + offset + 1);
+        if (size > (uint32_t)(length - offset - EXPORT_FRAME_HEADER)) {
+            break; // Cut when the page was serialized
+        }
+        if (tag == FRAME_HEADER || tag == FRAME_END || tag == FRAME_ARCHIVE || tag == FRAME_CONTEXT
+            || decoder_frame(decoder, tag, bytes + offset + EXPORT_FRAME_HEADER, (int)size) != 0) {
+            return -1; // Only page content may be nested
+        }
+        offset += EXPORT_FRAME_HEADER + (int)size;
+    }
+    return 0;
+}
+
+// Decompresses behind the compressed payload, the rest of the buffer holds the frames
+static int decoder_archive(logger_decoder_t *decoder, const uint8_t *payload, int length)
+{
+    if (length < 4) {
+        return -1;
+    }
+    const uint32_t raw_length = get_u32(payload);
+    char *raw = (char *)payload + length;
+    const int room = decoder->capacity - (int)(raw - decoder->buffer);
+    if (raw_length > (uint32_t)room
+        || logger_lz_decompress((const char *)payload + 4, length - 4, raw, (int)raw_length) != (int)raw_length) {
+        return -1;
+    }
+    return logger_decoder_frames(decoder, raw, (int)raw_length);
+}
+
+// Handles one complete frame, the payload sits in decoder->buffer
+static int decoder_frame(logger_decoder_t *decoder, char tag, const uint8_t *payload, int length)
+{
+    logger_export_item_t item;
+    memset(&item, 0, sizeof(item));
+    item.page_index = decoder->page_index;
+    item.version = decoder->version;
+
+    switch (tag) {
+        case FRAME_HEADER:
+            if (length < 16 || (payload[0] | (payload[1] << 8)) == 0 || (payload[0] | (payload[1] << 8)) > LOGGER_EXPORT_VERSION) {
+                return -1; // Newer major version
+            }
+            decoder->version = payload[0] | (payload[1] << 8);
+            item.event = LOGGER_EXPORT_HEADER;
+            item.version = decoder->version;
+            item.page_size = (int)get_u32(payload + 4);
+            item.page_count = (int)get_u32(payload + 8);
+            break;
+        case FRAME_PAGE:
+            if (length < 6) return -1;
+            decoder->page_index = (int)get_u32(payload);
+            decoder->timestamp = 0; // Deltas restart with every page
+            item.event = LOGGER_EXPORT_PAGE;
+            item.page_index = decoder->page_index;
+            item.type = (page_type_t)(int8_t)payload[4];
+            item.is_record = payload[5] == PAGE_FORMAT_RECORD;
+            break;
+        case FRAME_TEXT:
+            item.event = LOGGER_EXPORT_TEXT;
+            item.data = (const char *)payload;
+            item.length = length;
+            break;
+        case FRAME_RECORD: {
+            int header;
+            if (decoder->version == 1) {
+                if (length < EXPORT_RECORD_HEADER_V1) return -1;
+                decoder->timestamp = get_u32(payload);
+                item.type = (page_type_t)(int8_t)payload[4];
+                header = EXPORT_RECORD_HEADER_V1;
+            }
+            else {
+                const int n = get_delta(payload, length, &decoder->timestamp);
+                if (n == 0 || n >= length) return -1; // Cut varint or no level byte
+                item.type = (page_type_t)(int8_t)payload[n];
+                header = n + 1;
+            }
+            item.event = LOGGER_EXPORT_RECORD;
+            item.timestamp = decoder->timestamp;
+            item.data = (const char *)payload + header;
+            item.length = length - header;
+            break;
+        }
+        case FRAME_ARCHIVE:
+            if (decoder->version == 0) {
+                return -1;
+            }
+            return decoder_archive(decoder, payload, length);
+        case FRAME_CONTEXT: {
+            const int version = length >= 12 ? payload[0] | (payload[1] << 8) : 0;
+            if (version == 0 || version > LOGGER_EXPORT_VERSION) {
+                return -1;
+            }
+            decoder->version = version; // Stands in for the header and page frames lost before
+            decoder->page_index = (int)get_u32(payload + 2);
+            decoder->timestamp = get_u32(payload + 8);
+            return 0;
+        }
+        case FRAME_END:
+            if (length < 4 || get_u32(payload) != decoder->crc) {
+                return -1; // Corrupted on the way
+            }
+            item.event = LOGGER_EXPORT_END;
+            break;
+        default:
+            return 0; // Unknown frame of a later version, skipped
+    }
+    if (decoder->version == 0) {
+        return -1; // Stream did not start with a header
+    }
+    decoder->callback(decoder->ctx, &item);
+    if (tag == FRAME_END) {
+        decoder->version = 0; // Ready for the next stream
+        decoder->crc = 0;
+        decoder->page_index = 0;
+        decoder->timestamp = 0;
+    }
+    return 0;
+}
+
+int logger_decoder_feed(logger_decoder_t *decoder, const char *data, int length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (int i = 0; i < length; ) {
+        if (decoder->have < EXPORT_FRAME_HEADER) {
+            decoder->frame[decoder->have++] = bytes[i++];
+            if (decoder->have == EXPORT_FRAME_HEADER) {
+                decoder->need = (int)get_u32(decoder->frame + 1);
+                if (decoder->need < 0 || decoder->need > decoder->capacity
+                    || (decoder->frame[0] == FRAME_TEXT && decoder->need > LOGGER_EXPORT_CHUNK)) {
+                    return -1; // Corrupt stream, or a frame larger than the buffer
+                }
+            }
+        }
+        else {
+            int take = decoder->need - (decoder->have - EXPORT_FRAME_HEADER);
+            if (take > length - i) {
+                take = length - i;
+            }
+            memcpy(decoder->buffer + decoder->have - EXPORT_FRAME_HEADER, bytes + i, take);
+            decoder->have += take;
+            i += take;
+        }
+
+        if (decoder->have >= EXPORT_FRAME_HEADER && decoder->have - EXPORT_FRAME_HEADER == decoder->need) {
+            char tag = (char)decoder->frame[0];
+            if (tag != FRAME_END && tag != FRAME_CONTEXT) {
+                decoder->crc = logger_crc32(decoder->crc, decoder->frame, EXPORT_FRAME_HEADER);
+                decoder->crc = logger_crc32(decoder->crc, decoder->buffer, decoder->need);
+            }
+            // The buffer is not touched after this, a header callback may replace it
+            if (decoder_frame(decoder, tag, (const uint8_t *)decoder->buffer, decoder->need) != 0) {
+                return -1;
+            }
+            decoder->have = 0;
+        }
+    }
+    return 0;
+}
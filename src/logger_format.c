@@ -0,0 +1,351 @@
+#include "logger_format.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Rendered size limit of a single conversion, longer output is truncated
+#define FORMAT_CONVERSION_MAX 128
+
+// Longest printf conversion spec we keep, star arguments included once expanded
+#define FORMAT_SPEC_MAX 32
+
+// Literal precisions are clamped here while parsing, larger ones cannot overflow
+#define FORMAT_PRECISION_MAX 100000000
+
+typedef enum {
+    ARG_NONE = 0,   // "%%", takes no argument
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_SIZE,
+    ARG_INTMAX,
+    ARG_PTRDIFF,
+    ARG_DOUBLE,
+    ARG_LDOUBLE,
+    ARG_PTR,
+    ARG_STR,
+    ARG_INVALID     // Unknown conversion or %n
+} arg_class_t;
+
+typedef struct {
+    const char *start;  // Points at the '%'
+    int length;         // Spec length, conversion character included
+    int stars;          // '*' width/precision arguments taken before the value
+    int precision;      // Literal precision, -1 when absent or given by a star
+    int precision_star; // Precision is the last star argument
+    char conversion;
+    arg_class_t cls;
+} format_spec;
+
+// --- Conversion spec parsing ---
+static const char *parse_spec(const char *p, format_spec *spec)
+{
+    spec->start = p++;
+    spec->stars = 0;
+    spec->precision = -1;
+    spec->precision_star = 0;
+
+    while (*p && strchr("-+ #0'", *p)) p++;                 // Flags
+    if (*p == '*') { spec->stars++; p++; }                  // Width
+    else while (*p >= '0' && *p <= '9') p++;
+    if (*p == '.') {                                        // Precision
+        p++;
+        if (*p == '*') { spec->stars++; spec->precision_star = 1; p++; }
+        else {
+            spec->precision = 0; // "%.s" is a precision of zero
+            for (; *p >= '0' && *p <= '9'; p++) {
+                if (spec->precision < FORMAT_PRECISION_MAX) {
+                    spec->precision = spec->precision * 10 + (*p - '0');
+                }
+            }
+        }
+    }
+
+    int longs = 0;
+    char modifier = '\0';
+    for (;; p++) {                                          // Length modifier
+        if (*p == 'l') longs++;
+        else if (*p == 'h') continue;                       // Promoted to int anyway
+        else if (*p == 'j' || *p == 'z' || *p == 't' || *p == 'L') modifier = *p;
+        else break;
+    }
+
+    spec->conversion = *p;
+    switch (*p) {
+        case '%':
+            spec->cls = ARG_NONE;
+            break;
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+            if (modifier == 'j') spec->cls = ARG_INTMAX;
+            else if (modifier == 'z') spec->cls = ARG_SIZE;
+            else if (modifier == 't') spec->cls = ARG_PTRDIFF;
+            else if (longs >= 2) spec->cls = ARG_LLONG;
+            else if (longs == 1) spec->cls = ARG_LONG;
+            else spec->cls = ARG_INT;
+            break;
+        case 'c':
+            // %lc takes a wint_t, not packed
+            spec->cls = (longs > 0 || modifier != '\0') ? ARG_INVALID : ARG_INT;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec->cls = (modifier == 'L') ? ARG_LDOUBLE : ARG_DOUBLE;
+            break;
+        case 'p':
+            spec->cls = ARG_PTR;
+            break;
+        case 's':
+            // %ls reads a wchar_t string, only narrow ones are copied
+            spec->cls = (longs > 0 || modifier != '\0') ? ARG_INVALID : ARG_STR;
+            break;
+        default:
+            spec->cls = ARG_INVALID; // Includes %n and a truncated spec
+            return p;
+    }
+
+    p++;
+    spec->length = (int)(p - spec->start);
+    if (spec->length + spec->stars * 10 >= FORMAT_SPEC_MAX) {
+        spec->cls = ARG_INVALID; // Would not fit spec_buf once the stars are expanded
+    }
+    return p;
+}
+
+// --- Packing ---
+// Consumes the arguments of fmt; only counts when out is NULL
+static int format_walk(const char *fmt, va_list args, char *out)
+{
+    int used = sizeof(const char *);
+    if (out != NULL) {
+        memcpy(out, &fmt, sizeof(const char *));
+    }
+
+#define PACK(value) do { \
+        if (out != NULL) memcpy(out + used, &(value), sizeof(value)); \
+        used += sizeof(value); \
+    } while (0)
+
+    for (const char *p = fmt; *p; ) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+
+        format_spec spec;
+        p = parse_spec(p, &spec);
+        if (spec.cls == ARG_INVALID) {
+            return -1;
+        }
+
+        int precision = spec.precision;
+        for (int i = 0; i < spec.stars; i++) {
+            int star = va_arg(args, int);
+            PACK(star);
+            if (spec.precision_star && i == spec.stars - 1) {
+                precision = star; // Negative reads as no precision, like printf
+            }
+        }
+
+        switch (spec.cls) {
+            case ARG_INT:     { int v = va_arg(args, int); PACK(v); break; }
+            case ARG_LONG:    { long v = va_arg(args, long); PACK(v); break; }
+            case ARG_LLONG:   { long long v = va_arg(args, long long); PACK(v); break; }
+            case ARG_SIZE:    { size_t v = va_arg(args, size_t); PACK(v); break; }
+            case ARG_INTMAX:  { intmax_t v = va_arg(args, intmax_t); PACK(v); break; }
+            case ARG_PTRDIFF: { ptrdiff_t v = va_arg(args, ptrdiff_t); PACK(v); break; }
+            case ARG_DOUBLE:  { double v = va_arg(args, double); PACK(v); break; }
+            case ARG_LDOUBLE: { long double v = va_arg(args, long double); PACK(v); break; }
+            case ARG_PTR:     { void *v = va_arg(args, void *); PACK(v); break; }
+            case ARG_STR: {
+                // The string may not outlive the call, so its characters are copied
+                const char *str = va_arg(args, const char *);
+                if (str == NULL) {
+                    str = "(null)";
+                }
+                // Only the characters printed are read, the buffer may not be terminated
+                size_t len = precision >= 0 ? strnlen(str, (size_t)precision) : strlen(str);
+                uint16_t stored = len > UINT16_MAX ? UINT16_MAX : (uint16_t)len;
+                PACK(stored);
+                if (out != NULL) memcpy(out + used, str, stored);
+                used += stored;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+#undef PACK
+    return used;
+}
+
+int logger_format_packed_size(const char *fmt, va_list args)
+{
+    va_list copy;
+    va_copy(copy, args);
+    int size = format_walk(fmt, copy, NULL);
+    va_end(copy);
+    return size;
+}
+
+int logger_format_pack(char *out, const char *fmt, va_list args)
+{
+    va_list copy;
+    va_copy(copy, args);
+    int size = format_walk(fmt, copy, out);
+    va_end(copy);
+    return size;
+}
+
+// --- Rendering ---
+static int read_arg(const char **p, const char *end, void *value, size_t size)
+{
+    if ((size_t)(end - *p) < size) {
+        return -1; // Truncated record
+    }
+    memcpy(value, *p, size);
+    *p += size;
+    return 0;
+}
+
+void logger_format_render(const char *packed, int length, logger_emit_fn emit, void *ctx)
+{
+    const char *end = packed + length;
+    const char *fmt;
+    if (read_arg(&packed, end, &fmt, sizeof(fmt)) != 0) {
+        return;
+    }
+
+    char out[FORMAT_CONVERSION_MAX];
+    const char *literal = fmt;
+    const char *p = fmt;
+    while (*p) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        if (p != literal) {
+            emit(ctx, literal, (int)(p - literal));
+        }
+
+        format_spec spec;
+        p = parse_spec(p, &spec);
+        literal = p;
+        if (spec.cls == ARG_INVALID) {
+            return;
+        }
+        if (spec.cls == ARG_NONE) {
+            emit(ctx, "%", 1);
+            continue;
+        }
+
+        // Rebuild the spec with star arguments expanded to their stored values
+        char spec_buf[FORMAT_SPEC_MAX];
+        int spec_len = 0;
+        for (int i = 0; i < spec.length; i++) {  // Fits, parse_spec() checked
+            if (spec.start[i] == '*') {
+                int star;
+                if (read_arg(&packed, end, &star, sizeof(star)) != 0) {
+                    return;
+                }
+                if (star < 0 && spec.start[i - 1] == '.') {
+                    spec_len--; // Negative precision is no precision, drop the '.'
+                    continue;
+                }
+                spec_len += snprintf(spec_buf + spec_len, FORMAT_SPEC_MAX - spec_len, "%d", star);
+            }
+            else {
+                spec_buf[spec_len++] = spec.start[i];
+            }
+        }
+        spec_buf[spec_len] = '\0';
+
+        const int is_unsigned = strchr("ouxX", spec.conversion) != NULL;
+        int n = 0;
+        switch (spec.cls) {
+            case ARG_INT: {
+                int v;
+                if (read_arg(&packed, end, &v, sizeof(v)) != 0) return;
+                n = is_unsigned ? snprintf(out, sizeof(out), spec_buf, (unsigned int)v)
+                                : snprintf(out, sizeof(out), spec_buf, v);
+                break;
+            }
+            case ARG_LONG: {
+                long v;
+                if (read_arg(&packed, end, &v, sizeof(v)) != 0) return;
+                n = is_unsigned ? snprintf(out, sizeof(out), spec_buf, (unsigned long)v)
+                                : snprintf(out, sizeof(out), spec_buf, v);
+                break;
+            }
+            case ARG_LLONG: {
+                long long v;
+                if (read_arg(&packed, end, &v, sizeof(v)) != 0) return;
+                n = is_unsigned ? snprintf(out, sizeof(out), spec_buf, (unsigned long long)v)
+                                : snprintf(out, sizeof(out), spec_buf, v);
+                break;
+            }
+            case ARG_SIZE: {
+                size_t v;
+                if (read_arg(&packed, end, &v, sizeof(v)) != 0) return;
+                n = snprintf(out, sizeof(out), spec_buf, v);
+                break;
+            }
+            case ARG_INTMAX: {
+                intmax_t v;
+                if (read_arg(&packed, end, &v, sizeof(v)) != 0) return;
+                n = is_unsigned ? snprintf(out, sizeof(out), spec_buf, (uintmax_t)v)
+                                : snprintf(out, sizeof(out), spec_buf, v);
+                break;
+            }
+            case ARG_PTRDIFF: {
+                ptrdiff_t v;
+                if (read_arg(&packed, end, &v, sizeof(v)) != 0) return;
+                n = snprintf(out, sizeof(out), spec_buf, v);
+                break;
+            }
+            case ARG_DOUBLE: {
+                double v;
+                if (read_arg(&packed, end, &v, sizeof(v)) != 0) return;
+                n = snprintf(out, sizeof(out), spec_buf, v);
+                break;
+            }
+            case ARG_LDOUBLE: {
+                long double v;
+                if (read_arg(&packed, end, &v, sizeof(v)) != 0) return;
+                n = snprintf(out, sizeof(out), spec_buf, v);
+                break;
+            }
+            case ARG_PTR: {
+                void *v;
+                if (read_arg(&packed, end, &v, sizeof(v)) != 0) return;
+                n = snprintf(out, sizeof(out), spec_buf, v);
+                break;
+            }
+            case ARG_STR: {
+                uint16_t len;
+                if (read_arg(&packed, end, &len, sizeof(len)) != 0 || end - packed < len) return;
+                const char *str = packed;
+                packed += len;
+                if (spec.length == 2) {
+                    emit(ctx, str, len); // Plain "%s", no need to go through snprintf
+                    continue;
+                }
+                char tmp[FORMAT_CONVERSION_MAX];
+                int copy = len < (int)sizeof(tmp) - 1 ? len : (int)sizeof(tmp) - 1;
+                memcpy(tmp, str, copy);
+                tmp[copy] = '\0';
+                n = snprintf(out, sizeof(out), spec_buf, tmp);
+                break;
+            }
+            default:
+                break;
+        }
+
+        if (n > 0) {
+            emit(ctx, out, n < (int)sizeof(out) ? n : (int)sizeof(out) - 1);
+        }
+    }
+
+    if (p != literal) {
+        emit(ctx, literal, (int)(p - literal));
+    }
+}
@@ -0,0 +1,281 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_pool.h"
+#include "logger_port.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+// --- Logger groups ---
+// One allocation holds the group, the arena of every member and the shared slabs:
+//
+//   [group, member table][free slab stack][member arenas, one cell each][shared slabs]
+//
+// Members are ordinary loggers built in their cell, so every logger function works
+// on them. Their growth pool borrows slabs from the shared region instead of the
+// heap, and logger_group_shrink() takes back what a quiet member no longer uses.
+
+#define GROUP_SLAB_ALIGNMENT ALIGNOF(max_align_t) // What mallocv() gives a heap slab
+
+typedef struct {
+    LoggerHandler logger;       // NULL while the cell is free
+    char name[LOGGER_GROUP_NAME_SIZE];
+} group_member;
+
+struct logger_group_t {
+    logger_group_config_t config;
+    logger_sem_t lock;          // Used as a mutex over the member table and the drain worker
+    atomic_flag slab_lock;      // Free slab stack, taken inside the rotate lock of a member
+    struct logger_drain *drain; // Shared worker, NULL until logger_group_drain_start()
+    size_t cell_size;           // Stride of the member arenas
+    size_t slab_size;           // Stride of the shared slabs
+    int slabs;
+    int free_count;
+    void **free;                // Stack of the slabs not lent out
+    unsigned char *cells;
+    group_member members[];
+};
+
+// Buffer alignment logger_create_in() picks for the default layout
+static size_t group_alignment(void)
+{
+    return BUFFER_ALIGNMENT > ALIGNOF(page_list) ? BUFFER_ALIGNMENT : ALIGNOF(page_list);
+}
+
+LoggerGroupHandler logger_group_create(const logger_group_config_t *config)
+{
+    if (config == NULL || config->max_loggers <= 0 || config->base_pages < 2 || config->page_size < 2
+        || config->shared_pages < 0 || config->slab_pages <= 0) {
+        return NULL;
+    }
+
+    const size_t align = group_alignment();
+    const int slabs = config->shared_pages / config->slab_pages;
+    const size_t cell_size = ALIGN_PTR(logger_arena_size(config->base_pages, config->page_size, LOGGER_LAYOUT_INLINE, align),
+                                       ALIGNOF(struct logger_t));
+    const size_t slab_size = ALIGN_PTR(logger_pool_slab_size(config->slab_pages, config->page_size, LOGGER_LAYOUT_INLINE, align),
+                                       GROUP_SLAB_ALIGNMENT);
+
+    // Offsets from an aligned start, the allocation carries the slack to get there
+    const size_t head = ALIGN_PTR(sizeof(struct logger_group_t) + config->max_loggers * sizeof(group_member), ALIGNOF(void *));
+    const size_t cells = ALIGN_PTR(head + slabs * sizeof(void *), ALIGNOF(struct logger_t));
+    const size_t shared = ALIGN_PTR(cells + config->max_loggers * cell_size, GROUP_SLAB_ALIGNMENT);
+    const size_t total = shared + slabs * slab_size + ALIGNOF(struct logger_t) + GROUP_SLAB_ALIGNMENT;
+
+    unsigned char *memory = mallocv(total);
+    if (memory == NULL) {
+        return NULL;
+    }
+    LoggerGroupHandler group = (LoggerGroupHandler)memory;
+    if (logger_sem_init(&group->lock) != 0) {
+        freev(memory);
+        return NULL;
+    }
+    logger_sem_post(&group->lock);
+    atomic_flag_clear(&group->slab_lock);
+    group->config = *config;
+    group->drain = NULL;
+    group->cell_size = cell_size;
+    group->slab_size = slab_size;
+    group->slabs = slabs;
+    group->free = (void **)(memory + head);
+    group->cells = (unsigned char *)ALIGN_PTR(memory + cells, ALIGNOF(struct logger_t));
+
+    unsigned char *slab = (unsigned char *)ALIGN_PTR(group->cells + (shared - cells), GROUP_SLAB_ALIGNMENT);
+    for (int i = 0; i < slabs; i++) {
+        group->free[i] = slab + (size_t)i * slab_size;
+    }
+    group->free_count = slabs;
+    for (int i = 0; i < config->max_loggers; i++) {
+        group->members[i].logger = NULL;
+    }
+    return group;
+}
+
+// --- Shared slabs ---
+static void group_slab_lock(LoggerGroupHandler group)
+{
+    while (atomic_flag_test_and_set_explicit(&group->slab_lock, memory_order_acquire)) {
+        logger_sleep_ms(1); // Held for a few stores only
+    }
+}
+
+void *logger_group_take(struct logger_group_t *group)
+{
+    group_slab_lock(group);
+    void *slab = group->free_count > 0 ? group->free[--group->free_count] : NULL;
+    atomic_flag_clear_explicit(&group->slab_lock, memory_order_release);
+    return slab;
+}
+
+void logger_group_give(struct logger_group_t *group, void *slab)
+{
+    group_slab_lock(group);
+    group->free[group->free_count++] = slab;
+    atomic_flag_clear_explicit(&group->slab_lock, memory_order_release);
+}
+
+int logger_group_free_pages(LoggerGroupHandler group)
+{
+    if (group == NULL) {
+        return -1;
+    }
+    group_slab_lock(group);
+    const int pages = group->free_count * group->config.slab_pages;
+    atomic_flag_clear_explicit(&group->slab_lock, memory_order_release);
+    return pages;
+}
+
+// --- Members ---
+static group_member *group_find(LoggerGroupHandler group, const char *name)
+{
+    for (int i = 0; i < group->config.max_loggers; i++) {
+        if (group->members[i].logger != NULL && strcmp(group->members[i].name, name) == 0) {
+            return &group->members[i];
+        }
+    }
+    return NULL;
+}
+
+// Builds the member of a free cell, caller holds the group lock
+static LoggerHandler group_build(LoggerGroupHandler group, int index)
+{
+    logger_config_t config = LOGGER_CONFIG_DEFAULT(group->config.base_pages, group->config.page_size);
+    config.ring = group->config.ring;
+    LoggerHandler logger = logger_create_in(&config, group->cells + (size_t)index * group->cell_size, group->cell_size);
+    if (logger == NULL) {
+        return NULL;
+    }
+    if ((group->slabs > 0 && logger_pool_share(logger, group, group->config.slab_pages, group->slabs) != 0)
+        || (group->drain != NULL && logger_drain_attach(group->drain, logger) != 0)) {
+        logger_destroy(logger);
+        return NULL;
+    }
+    return logger;
+}
+
+LoggerHandler logger_group_add(LoggerGroupHandler group, const char *name)
+{
+    if (group == NULL || name == NULL || name[0] == '\0' || strlen(name) >= LOGGER_GROUP_NAME_SIZE) {
+        return NULL;
+    }
+
+    LoggerHandler logger = NULL;
+    logger_sem_wait(&group->lock, -1);
+    if (group_find(group, name) == NULL) {
+        for (int i = 0; i < group->config.max_loggers; i++) {
+            group_member *member = &group->members[i];
+            if (member->logger == NULL) {
+                logger = group_build(group, i);
+                if (logger != NULL) {
+                    strcpy(member->name, name);
+                    member->logger = logger;
+                }
+                break;
+            }
+        }
+    }
+    logger_sem_post(&group->lock);
+    return logger;
+}
+
+LoggerHandler logger_group_get(LoggerGroupHandler group, const char *name)
+{
+    if (group == NULL || name == NULL) {
+        return NULL;
+    }
+    logger_sem_wait(&group->lock, -1);
+    const group_member *member = group_find(group, name);
+    LoggerHandler logger = member != NULL ? member->logger : NULL;
+    logger_sem_post(&group->lock);
+    return logger;
+}
+
+int logger_group_remove(LoggerGroupHandler group, const char *name)
+{
+    if (group == NULL || name == NULL) {
+        return -1;
+    }
+    logger_sem_wait(&group->lock, -1);
+    group_member *member = group_find(group, name);
+    if (member != NULL) {
+        logger_destroy(member->logger); // Drains it and gives its slabs back
+        member->logger = NULL;
+    }
+    logger_sem_post(&group->lock);
+    return member != NULL ? 0 : -1;
+}
+
+int logger_group_shrink(LoggerGroupHandler group)
+{
+    if (group == NULL) {
+        return -1;
+    }
+    int pages = 0;
+    logger_sem_wait(&group->lock, -1);
+    for (int i = 0; i < group->config.max_loggers; i++) {
+        if (group->members[i].logger != NULL) {
+            pages += logger_shrink(group->members[i].logger);
+        }
+    }
+    logger_sem_post(&group->lock);
+    return pages;
+}
+
+// --- Shared drain worker ---
+int logger_group_drain_start(LoggerGroupHandler group, const logger_drain_config_t *config)
+{
+    if (group == NULL) {
+        return -1;
+    }
+    int result = -1;
+    logger_sem_wait(&group->lock, -1);
+    if (group->drain == NULL) {
+        struct logger_drain *drain = logger_drain_open(config, group->config.max_loggers, 1);
+        result = drain != NULL ? 0 : -1;
+        for (int i = 0; result == 0 && i < group->config.max_loggers; i++) {
+            if (group->members[i].logger != NULL && logger_drain_attach(drain, group->members[i].logger) != 0) {
+                logger_drain_close(drain); // A member with a worker of its own
+                result = -1;
+            }
+        }
+        if (result == 0) {
+            group->drain = drain;
+        }
+    }
+    logger_sem_post(&group->lock);
+    return result;
+}
+
+void logger_group_drain_stop(LoggerGroupHandler group)
+{
+    if (group == NULL) {
+        return;
+    }
+    logger_sem_wait(&group->lock, -1);
+    if (group->drain != NULL) {
+        for (int i = 0; i < group->config.max_loggers; i++) {
+            if (group->members[i].logger != NULL) {
+                logger_drain_sync(group->members[i].logger); // Head pages too
+            }
+        }
+        logger_drain_close(group->drain);
+        group->drain = NULL;
+    }
+    logger_sem_post(&group->lock);
+}
+
+void logger_group_destroy(LoggerGroupHandler group)
+{
+    if (group == NULL) {
+        return;
+    }
+    logger_group_drain_stop(group);
+    for (int i = 0; i < group->config.max_loggers; i++) {
+        if (group->members[i].logger != NULL) {
+            logger_destroy(group->members[i].logger);
+        }
+    }
+    logger_sem_destroy(&group->lock);
+    freev(group);
+}
@@ -0,0 +1,172 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_port.h"
+#include <stdatomic.h>
+#include <string.h>
+
+// --- Interrupt-safe append ---
+// Interrupt handlers never touch the pages: each core owns a ring of records laid
+// out like a record page, and logger_isr_merge() later copies them onto the head
+// page through the normal path. A ring has one producer, the interrupts of its
+// core, and one consumer, so appending is a few loads, a copy and a release store.
+// A handler preempted by a nested interrupt of the same core keeps the ring busy
+// for that moment, the nested record is dropped rather than waited for.
+
+#ifndef LOGGER_ISR_RINGS
+#define LOGGER_ISR_RINGS 2          // Cores of an ESP32
+#endif
+
+typedef struct {
+    _Atomic uint32_t head;      // Bytes appended, written by the producer only
+    atomic_flag busy;           // Held while a record is written
+    char producer_gap[LOGGER_CACHE_LINE_SIZE];
+    _Atomic uint32_t tail;      // Bytes merged, written by the consumer only
+    char consumer_gap[LOGGER_CACHE_LINE_SIZE];
+} isr_ring;
+
+struct logger_isr {
+    uint32_t capacity;          // Bytes per ring, a power of two
+    atomic_flag merging;        // One consumer at a time, the drain worker or a task
+    isr_ring rings[LOGGER_ISR_RINGS];
+    char *data;                 // capacity bytes per ring, back to back
+};
+
+static inline char *ring_data(struct logger_isr *isr, int index)
+{
+    return isr->data + (size_t)index * isr->capacity;
+}
+
+int logger_isr_enable(LoggerHandler logger, int ring_size)
+{
+    if (logger == NULL || logger->isr != NULL || ring_size < (int)RECORD_SLOT_SIZE(1) * 2) {
+        return -1;
+    }
+    uint32_t capacity = RECORD_ALIGNMENT;
+    while (capacity < (uint32_t)ring_size) {
+        capacity <<= 1;
+    }
+
+    const size_t rings = ALIGN_PTR(sizeof(struct logger_isr), RECORD_ALIGNMENT);
+    struct logger_isr *isr = mallocv(rings + (size_t)capacity * LOGGER_ISR_RINGS);
+    if (isr == NULL) {
+        return -1;
+    }
+    isr->capacity = capacity;
+    atomic_flag_clear(&isr->merging);
+    for (int i = 0; i < LOGGER_ISR_RINGS; i++) {
+        atomic_init(&isr->rings[i].head, 0);
+        atomic_init(&isr->rings[i].tail, 0);
+        atomic_flag_clear(&isr->rings[i].busy);
+    }
+    isr->data = (char *)isr + rings;
+    logger->isr = isr;
+    return 0;
+}
+
+int LOGGER_ISR_ATTR logger_isr_log(LoggerHandler logger, page_type_t level, const char *data, int size)
+{
+    if (logger == NULL || logger->isr == NULL || data == NULL) {
+        return -1;
+    }
+    if (!logger_level_passes(logger, level)) {
+        return 0;
+    }
+    if (size <= 0) {
+        size = (int)strlen(data);
+    }
+
+    struct logger_isr *isr = logger->isr;
+    const int index = logger_thread_slot() % LOGGER_ISR_RINGS;
+    isr_ring *ring = &isr->rings[index];
+    const uint32_t slot = RECORD_SLOT_SIZE(size);
+    if (size > (int)RECORD_MAX_LENGTH || slot > isr->capacity / 2
+        || atomic_flag_test_and_set_explicit(&ring->busy, memory_order_acquire)) {
+        LOGGER_STAT_ADD(logger, drops, 1);
+        return -1;
+    }
+
+    // A record never wraps, the end of the ring is skipped when it does not fit there
+    const uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    const uint32_t offset = head & (isr->capacity - 1);
+    const uint32_t skip = isr->capacity - offset < slot ? isr->capacity - offset : 0;
+    if (head - tail + skip + slot > isr->capacity) {
+        atomic_flag_clear_explicit(&ring->busy, memory_order_release);
+        LOGGER_STAT_ADD(logger, drops, 1); // Not merged fast enough
+        return -1;
+    }
+
+    char *base = ring_data(isr, index);
+    if (skip >= sizeof(record_header)) {
+        ((record_header *)(base + offset))->kind = RECORD_KIND_PADDING; // Up to the end of the ring
+    }
+    record_header *header = (record_header *)(base + ((head + skip) & (isr->capacity - 1)));
+    header->length = (uint16_t)size;
+    header->slot = (uint16_t)slot;
+    header->kind = RECORD_KIND_TEXT;
+    header->level = (int8_t)level;
+    header->tag = 0;
+    header->timestamp = logger->clock(); // Must be interrupt safe too, see logger_set_clock()
+    memcpy(header + 1, data, size);
+
+    const uint32_t used = head - tail;
+    atomic_store_explicit(&ring->head, head + skip + slot, memory_order_release);
+    atomic_flag_clear_explicit(&ring->busy, memory_order_release);
+
+    if (used < isr->capacity / 2 && used + skip + slot >= isr->capacity / 2) {
+        logger_drain_notify_isr(logger); // Half full, merge before it overflows
+    }
+    return size;
+}
+
+// --- Merge, in task context ---
+static int ring_merge(LoggerHandler logger, struct logger_isr *isr, int index)
+{
+    isr_ring *ring = &isr->rings[index];
+    const char *base = ring_data(isr, index);
+    const uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    int merged = 0;
+    while (tail != head) {
+        const uint32_t offset = tail & (isr->capacity - 1);
+        const uint32_t left = isr->capacity - offset;
+        const record_header *header = (const record_header *)(base + offset);
+        if (left < sizeof(record_header) || header->kind == RECORD_KIND_PADDING) {
+            tail += left; // Skipped end of the ring
+            continue;
+        }
+        if (logger_log_at(logger, (page_type_t)header->level, header->timestamp,
+                          (const char *)(header + 1), header->length) >= 0) {
+            merged++;
+        }
+        tail += header->slot;
+    }
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    return merged;
+}
+
+int logger_isr_merge(LoggerHandler logger)
+{
+    if (logger == NULL || logger->isr == NULL) {
+        return -1;
+    }
+    struct logger_isr *isr = logger->isr;
+    while (atomic_flag_test_and_set_explicit(&isr->merging, memory_order_acquire)) {
+        logger_sleep_ms(1); // Another task is merging, its pass is short
+    }
+    int merged = 0;
+    for (int i = 0; i < LOGGER_ISR_RINGS; i++) {
+        merged += ring_merge(logger, isr, i);
+    }
+    atomic_flag_clear_explicit(&isr->merging, memory_order_release);
+    return merged;
+}
+
+void logger_isr_free(LoggerHandler logger)
+{
+    if (logger->isr != NULL) {
+        freev(logger->isr);
+        logger->isr = NULL;
+    }
+}
@@ -0,0 +1,420 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_port.h"
+#include "logger_scan.h"
+#include <string.h>
+
+// --- Network sink ---
+// Writes land in one byte queue and leave it in batches of up to batch_size bytes,
+// so a page drained as one span costs a system call per datagram, not per record.
+// The queue only ever holds whole units (text lines, or frames of the export
+// stream) ahead of the one still being written, and batches are cut between units:
+// every UDP datagram can be read on its own and dropping never splits a unit.
+// Record timestamps in the export stream are deltas, so a UDP datagram that starts
+// inside a page begins with a 'C' frame restoring what the frames before it set.
+// It is written right in front of the batch, over bytes already sent; headroom
+// ahead of the queue covers a batch that starts at offset 0.
+//
+//   [0, front)              sent, reclaimed by compaction
+//   [front, complete)       whole units waiting, the first `inflight` bytes are the
+//                           rest of a TCP write the socket took only partly
+//   [complete, length)      the unit being written
+
+#define NET_FRAME_HEADER 5          // [u8 tag][u32 length], see logger_export.c
+#define NET_FRAME_STREAM 'H'        // Header frame, starts a stream that needs no context
+#define NET_RETRY_US 1000000u       // Pause between connection attempts
+#define NET_WAIT_SLICE_MS 100       // LOGGER_NET_BLOCK re-checks its deadline this often
+#define NET_CLOSE_FLUSH_MS 1000
+
+struct logger_net {
+    logger_net_config_t config;
+    logger_sem_t lock;          // Used as a mutex, the drain worker and print calls may race
+    int fd;                     // -1 while disconnected
+    int attempted;
+    uint32_t attempt_us;        // Last connection attempt
+    int front;
+    int complete;
+    int length;
+    int inflight;
+    int discard;                // Dropping the rest of a unit that did not fit
+    int stalled;                // LOGGER_NET_BLOCK gave up waiting, drops until a send succeeds
+    int frame_have;             // Frame header bytes seen of the current unit
+    uint32_t frame_left;        // Payload bytes still to come
+    uint8_t frame[NET_FRAME_HEADER];
+    logger_export_context context; // Frames before front, UDP frame streams only
+    logger_net_stats_t stats;
+    char *queue;
+};
+
+static inline uint32_t net_get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// --- Unit boundaries ---
+
+// Bytes of data that belong to the current unit, *ends is set when it ends among them
+static int net_unit_span(struct logger_net *net, const char *data, int length, int *ends)
+{
+    if (net->config.format == LOGGER_FORMAT_TEXT) {
+        const char *newline = logger_scan_byte(data, length, '\n');
+        *ends = newline != NULL;
+        return newline != NULL ? (int)(newline - data) + 1 : length;
+    }
+
+    int taken = 0;
+    while (net->frame_have < NET_FRAME_HEADER && taken < length) {
+        net->frame[net->frame_have++] = (uint8_t)data[taken++];
+        if (net->frame_have == NET_FRAME_HEADER) {
+            net->frame_left = net_get_u32(net->frame + 1);
+        }
+    }
+    if (net->frame_have == NET_FRAME_HEADER) {
+        const int body = net->frame_left < (uint32_t)(length - taken) ? (int)net->frame_left : length - taken;
+        taken += body;
+        net->frame_left -= (uint32_t)body;
+    }
+    *ends = net->frame_have == NET_FRAME_HEADER && net->frame_left == 0;
+    if (*ends) {
+        net->frame_have = 0;
+    }
+    return taken;
+}
+
+// Length of the whole unit starting at offset, which lies before net->complete
+static int net_unit_length(const struct logger_net *net, int offset)
+{
+    const char *unit = net->queue + offset;
+    if (net->config.format == LOGGER_FORMAT_TEXT) {
+        return (int)(logger_scan_byte(unit, net->complete - offset, '\n') - unit) + 1;
+    }
+    return NET_FRAME_HEADER + (int)net_get_u32((const uint8_t *)unit + 1);
+}
+
+// End of the next batch: as many whole units as fit in budget bytes, at least one
+static int net_batch_end(const struct logger_net *net, int budget)
+{
+    if (net->complete - net->front <= budget) {
+        return net->complete;
+    }
+    int end = net->front + net_unit_length(net, net->front);
+    while (end < net->complete) {
+        const int next = end + net_unit_length(net, end);
+        if (next - net->front > budget) {
+            break;
+        }
+        end = next;
+    }
+    return end;
+}
+
+static int net_tracks_context(const struct logger_net *net)
+{
+    return net->config.transport == LOGGER_NET_UDP && net->config.format == LOGGER_FORMAT_FRAMES;
+}
+
+// Advances the context over the whole units of [start, end), sent or dropped
+static void net_track(struct logger_net *net, int start, int end)
+{
+    if (!net_tracks_context(net)) {
+        return;
+    }
+    for (int offset = start; offset < end; ) {
+        const int length = net_unit_length(net, offset);
+        logger_export_context_track(&net->context, net->queue + offset, length);
+        offset += length;
+    }
+}
+
+// --- Sending ---
+
+static int net_connect(struct logger_net *net)
+{
+    if (net->fd >= 0) {
+        return 0;
+    }
+    const uint32_t now = logger_now_us();
+    if (net->attempted && now - net->attempt_us < NET_RETRY_US) {
+        return -1;
+    }
+    net->attempted = 1;
+    net->attempt_us = now;
+    net->fd = logger_socket_open(net->config.host, net->config.port, net->config.transport == LOGGER_NET_TCP);
+    if (net->fd < 0) {
+        net->stats.errors++;
+        return -1;
+    }
+    return 0;
+}
+
+static void net_disconnect(struct logger_net *net)
+{
+    logger_socket_close(net->fd);
+    net->fd = -1;
+    net->attempt_us = logger_now_us(); // Next attempt after the retry pause
+    if (net->inflight > 0) {
+        // A new connection cannot start inside a unit
+        net->stats.dropped_bytes += (unsigned long)net->inflight;
+        net->front += net->inflight;
+        net->inflight = 0;
+    }
+}
+
+// Sends one batch, returns -1 when the socket is full or gone, 0 otherwise
+static int net_send_batch(struct logger_net *net, int timeout_ms)
+{
+    if (net_connect(net) != 0) {
+        return -1;
+    }
+    int prefix = 0;
+    if (net_tracks_context(net) && net->queue[net->front] != NET_FRAME_STREAM) {
+        prefix = logger_export_context_frame(&net->context, net->queue + net->front - LOGGER_EXPORT_CONTEXT_SIZE);
+    }
+    const int end = net->inflight > 0 ? net->front + net->inflight : net_batch_end(net, net->config.batch_size - prefix);
+    const int length = end - net->front;
+    int sent = logger_socket_send(net->fd, net->queue + net->front - prefix, prefix + length, timeout_ms);
+    if (sent == 0) {
+        return -1;
+    }
+    if (sent < 0) {
+        net->stats.errors++;
+        if (net->config.transport == LOGGER_NET_TCP) {
+            net_disconnect(net); // Unsent units stay queued for the next connection
+        }
+        else {
+            net->stats.dropped_bytes += (unsigned long)length; // Lost datagram
+            net_track(net, net->front, end);
+            net->front = end;
+        }
+        return -1;
+    }
+
+    net->stalled = 0;
+    net->stats.sent_bytes += (unsigned long)sent;
+    if (net->inflight == 0) {
+        net->stats.sends++;
+    }
+    sent -= prefix; // Datagrams go whole, prefix included
+    net_track(net, net->front, net->front + sent);
+    net->front += sent;
+    net->inflight = length - sent; // Only a stream socket takes part of a batch
+    return 0;
+}
+
+// Sends batches while a full one is waiting, or while anything is waiting when forced
+static void net_pump(struct logger_net *net, int force, int timeout_ms)
+{
+    while (net->complete > net->front
+           && (force || net->inflight > 0 || net->complete - net->front >= net->config.batch_size)) {
+        if (net_send_batch(net, timeout_ms) != 0) {
+            break;
+        }
+    }
+    if (net->front == net->length) {
+        net->front = net->complete = net->length = 0; // Empty, start over at the front
+    }
+}
+
+// --- Queue ---
+
+static void net_compact(struct logger_net *net)
+{
+    if (net->front > 0) {
+        memmove(net->queue, net->queue + net->front, net->length - net->front);
+        net->complete -= net->front;
+        net->length -= net->front;
+        net->front = 0;
+    }
+}
+
+static int net_room(const struct logger_net *net)
+{
+    return net->config.queue_size - (net->length - net->front);
+}
+
+// Drops whole units behind the pinned bytes until needed bytes are free
+static void net_drop_oldest(struct logger_net *net, int needed)
+{
+    const int start = net->front + net->inflight;
+    int end = start;
+    while (end < net->complete && net_room(net) + (end - start) < needed) {
+        end += net_unit_length(net, end);
+    }
+    if (end == start) {
+        return;
+    }
+    net_track(net, start, end); // What the receiver will not see still moves the timestamps
+    memmove(net->queue + start, net->queue + end, net->length - end);
+    net->stats.dropped_bytes += (unsigned long)(end - start);
+    net->complete -= end - start;
+    net->length -= end - start;
+}
+
+// Makes room for length bytes per the policy, returns 0 once they fit
+static int net_reserve(struct logger_net *net, int length)
+{
+    if (net->length + length <= net->config.queue_size) {
+        return 0;
+    }
+    net_pump(net, 1, 0);
+
+    if (net->config.policy == LOGGER_NET_BLOCK && !net->stalled && net_room(net) < length) {
+        const uint32_t start = logger_now_us();
+        while (net_room(net) < length && net->complete > net->front) {
+            const int waited = (int)((logger_now_us() - start) / 1000);
+            if (net->config.block_ms >= 0 && waited >= net->config.block_ms) {
+                net->stalled = 1; // Later writes do not wait for a dead link again
+                break;
+            }
+            int slice = NET_WAIT_SLICE_MS;
+            if (net->config.block_ms >= 0 && net->config.block_ms - waited < slice) {
+                slice = net->config.block_ms - waited;
+            }
+            if (net_connect(net) != 0) {
+                logger_sleep_ms(slice);
+                continue;
+            }
+            net_pump(net, 1, slice);
+        }
+    }
+
+    if (net_room(net) < length) {
+        net_drop_oldest(net, length);
+    }
+    net_compact(net);
+    return net->length + length <= net->config.queue_size ? 0 : -1;
+}
+
+static void net_append(struct logger_net *net, const char *data, int length)
+{
+    while (length > 0) {
+        int ends;
+        const int take = net_unit_span(net, data, length, &ends);
+        if (!net->discard && net_reserve(net, take) != 0) {
+            // The unit outgrew the queue, the part already queued goes too
+            net->stats.dropped_bytes += (unsigned long)(net->length - net->complete);
+            net->length = net->complete;
+            net->discard = 1;
+        }
+        if (net->discard) {
+            net->stats.dropped_bytes += (unsigned long)take;
+        }
+        else {
+            memcpy(net->queue + net->length, data, take);
+            net->length += take;
+        }
+        if (ends) {
+            net->complete = net->length;
+            net->discard = 0;
+        }
+        data += take;
+        length -= take;
+    }
+    net_pump(net, 0, 0);
+}
+
+// --- Sink ---
+
+static int net_sink_write(void *ctx, const char *data, int length)
+{
+    struct logger_net *net = ctx;
+    logger_sem_wait(&net->lock, -1);
+    net_append(net, data, length);
+    logger_sem_post(&net->lock);
+    return length;
+}
+
+static void net_sink_flush(void *ctx)
+{
+    struct logger_net *net = ctx;
+    logger_sem_wait(&net->lock, -1);
+    net_pump(net, 1, 0); // What the socket does not take now goes with the next batch
+    logger_sem_post(&net->lock);
+}
+
+logger_net_t *logger_net_open(const logger_net_config_t *config)
+{
+    if (config == NULL || config->host == NULL || config->port <= 0 || config->port > 65535
+        || config->batch_size <= 0 || config->queue_size < config->batch_size) {
+        return NULL;
+    }
+
+    const int host_size = (int)strlen(config->host) + 1;
+    struct logger_net *net = mallocv(sizeof(struct logger_net) + LOGGER_EXPORT_CONTEXT_SIZE + config->queue_size + host_size);
+    if (net == NULL) {
+        return NULL;
+    }
+    memset(net, 0, sizeof(*net));
+    if (logger_sem_init(&net->lock) != 0) {
+        freev(net);
+        return NULL;
+    }
+    logger_sem_post(&net->lock);
+
+    net->config = *config;
+    net->queue = (char *)(net + 1) + LOGGER_EXPORT_CONTEXT_SIZE; // Headroom for a 'C' frame
+    char *host = net->queue + config->queue_size;
+    memcpy(host, config->host, host_size);
+    net->config.host = host;
+    net->fd = -1;
+    net_connect(net); // A collector that is not up yet is tried again later
+    return net;
+}
+
+logger_sink_t logger_net_sink(logger_net_t *net)
+{
+    logger_sink_t sink = { net_sink_write, net, net_sink_flush };
+    return sink;
+}
+
+int logger_net_flush(logger_net_t *net, int timeout_ms)
+{
+    if (net == NULL) {
+        return -1;
+    }
+    const uint32_t start = logger_now_us();
+    logger_sem_wait(&net->lock, -1);
+    for (;;) {
+        net_pump(net, 1, 0);
+        const int waited = (int)((logger_now_us() - start) / 1000);
+        if (net->complete == net->front || (timeout_ms >= 0 && waited >= timeout_ms)) {
+            break;
+        }
+        int slice = NET_WAIT_SLICE_MS;
+        if (timeout_ms >= 0 && timeout_ms - waited < slice) {
+            slice = timeout_ms - waited;
+        }
+        if (net_connect(net) != 0) {
+            logger_sleep_ms(slice);
+        }
+        else {
+            net_pump(net, 1, slice);
+        }
+    }
+    const int empty = net->complete == net->front;
+    logger_sem_post(&net->lock);
+    return empty ? 0 : -1;
+}
+
+int logger_net_get_stats(logger_net_t *net, logger_net_stats_t *stats)
+{
+    if (net == NULL || stats == NULL) {
+        return -1;
+    }
+    logger_sem_wait(&net->lock, -1);
+    *stats = net->stats;
+    stats->connected = net->fd >= 0;
+    logger_sem_post(&net->lock);
+    return 0;
+}
+
+void logger_net_close(logger_net_t *net)
+{
+    if (net == NULL) {
+        return;
+    }
+    logger_net_flush(net, NET_CLOSE_FLUSH_MS);
+    logger_socket_close(net->fd);
+    logger_sem_destroy(&net->lock);
+    freev(net);
+}
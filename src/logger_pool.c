@@ -0,0 +1,330 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_pool.h"
+#include "logger_port.h"
+#include <stdatomic.h>
+
+// --- Dynamic page growth ---
+// Slabs are stacked newest first. Each one takes the next indices of the page
+// table, so only a run of the newest slabs can be released without renumbering
+// the pages that stay. A logger of a group borrows its slabs from the group's
+// shared region instead of the heap and gives them back the same way.
+
+typedef struct logger_slab {
+    struct logger_slab *next;   // Next older slab
+    size_t size;                // Bytes of the allocation, pages included
+    int first;                  // Index of its first page
+    int count;
+    int idle;                   // Found idle by the previous logger_shrink()
+    unsigned int epochs;        // Sum of its page generations seen then
+} logger_slab;
+
+struct logger_pool {
+    logger_growth_t config;
+    int enabled;                // Cleared by logger_set_growth(NULL), slabs stay until released
+    int base_pages;             // Pages of the arena itself
+    int capacity;               // Entries of table
+    size_t slab_size;           // Allocation of the next slab
+    size_t bytes;               // Memory of the live slabs
+    logger_slab *slabs;         // Newest first
+    struct logger_group_t *group; // Lends the slabs, NULL when they come from the heap
+    page_list **base_table;     // Table inside the arena, restored once the pool goes away
+    page_list *table[];         // Stands in for logger->page_table while the pool exists
+};
+
+size_t logger_pool_slab_size(int count, int page_size, logger_layout_t layout, size_t align)
+{
+    return ALIGN_PTR(sizeof(logger_slab), ALIGNOF(page_list)) + logger_pages_size(count, page_size, layout, align);
+}
+
+static size_t pool_slab_size(LoggerHandler logger, int count)
+{
+    return logger_pool_slab_size(count, logger->page_buffer_size, logger->layout, logger->buffer_alignment);
+}
+
+static void *pool_slab_alloc(struct logger_pool *pool)
+{
+    return pool->group != NULL ? logger_group_take(pool->group) : mallocv(pool->slab_size);
+}
+
+static void pool_slab_free(struct logger_group_t *group, logger_slab *slab)
+{
+    if (group != NULL) {
+        logger_group_give(group, slab);
+    }
+    else {
+        freev(slab);
+    }
+}
+
+int logger_pool_grow(LoggerHandler logger, page_list *full)
+{
+    struct logger_pool *pool = logger->pool;
+    if (pool == NULL || !pool->enabled
+        || logger_free_pages(logger, full, pool->config.watermark) > pool->config.watermark) {
+        return -1;
+    }
+    const int count = pool->config.slab_pages;
+    if (logger->total_pages + count > pool->capacity || pool->bytes + pool->slab_size > pool->config.max_bytes) {
+        return -1; // Hard cap reached
+    }
+
+    logger_slab *slab = pool_slab_alloc(pool);
+    if (slab == NULL) {
+        return -1; // Heap or shared region exhausted
+    }
+    slab->next = pool->slabs;
+    slab->size = pool->slab_size;
+    slab->first = logger->total_pages;
+    slab->count = count;
+    slab->idle = 0;
+    slab->epochs = 0;
+
+    logger_persist geometry;
+    geometry.page_amount = count;
+    geometry.page_size = logger->page_buffer_size;
+    geometry.buffer_alignment = logger->buffer_alignment;
+    geometry.layout = (uint16_t)logger->layout;
+    const uintptr_t memory = ALIGN_PTR((uintptr_t)slab + sizeof(logger_slab), ALIGNOF(page_list));
+
+    // Chain the new pages among themselves, then splice them in after the full page
+    page_list *first = NULL;
+    page_list *last = NULL;
+    for (int i = 0; i < count; i++) {
+        uintptr_t entry, buffer;
+        logger_layout_pages(&geometry, memory, i, &entry, &buffer);
+        page_list *page = (page_list *)entry;
+        page_init_empty(logger, page, (char *)buffer);
+        if (last != NULL) {
+            last->list.next = &page->list;
+            page->list.prev = &last->list;
+        }
+        else {
+            first = page;
+            page->list.prev = &full->list;
+        }
+        last = page;
+        pool->table[slab->first + i] = page;
+    }
+    last->list.next = full->list.next;
+    atomic_thread_fence(memory_order_release); // Readers walking forward see whole pages
+    full->list.next->prev = &last->list;
+    full->list.next = &first->list;
+
+    pool->slabs = slab;
+    pool->bytes += slab->size;
+    logger->total_pages += count;
+    return 0;
+}
+
+// --- Release ---
+static int slab_holds(const logger_slab *slab, const page_list *page)
+{
+    return (uintptr_t)page >= (uintptr_t)slab && (uintptr_t)page < (uintptr_t)slab + slab->size;
+}
+
+// Idle slabs hold no page that the head writes to or that still has to be written out
+static int slab_idle(LoggerHandler logger, struct logger_pool *pool, const logger_slab *slab)
+{
+    page_list *head = atomic_load_explicit(&logger->head, memory_order_relaxed);
+    if (logger->drain != NULL) {
+        // Pages from the tail up to the head wait for the worker, the others were drained
+        page_list *page = atomic_load_explicit(&logger->tail, memory_order_relaxed);
+        for (;;) {
+            if (slab_holds(slab, page)) {
+                return 0;
+            }
+            if (page == head) {
+                return 1;
+            }
+            page = page_next(logger, page);
+        }
+    }
+    for (int i = 0; i < slab->count; i++) {
+        page_list *page = pool->table[slab->first + i];
+        if (page == head || page_fill(logger, page) > 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Changes whenever one of its pages is reset, e.g. by becoming the head
+static unsigned int slab_epochs(struct logger_pool *pool, const logger_slab *slab)
+{
+    unsigned int sum = 0;
+    for (int i = 0; i < slab->count; i++) {
+        sum += atomic_load_explicit(&pool->table[slab->first + i]->epoch, memory_order_relaxed);
+    }
+    return sum;
+}
+
+static void slab_unlink(LoggerHandler logger, struct logger_pool *pool, logger_slab *slab)
+{
+    for (int i = 0; i < slab->count; i++) {
+        list_del(&pool->table[slab->first + i]->list);
+        pool->table[slab->first + i] = NULL;
+    }
+    logger->total_pages -= slab->count;
+    pool->bytes -= slab->size;
+}
+
+// Hands the arena table back once growth is off and every slab is gone, caller holds the rotate lock
+static struct logger_pool *pool_detach(LoggerHandler logger)
+{
+    struct logger_pool *pool = logger->pool;
+    if (pool == NULL || pool->enabled || pool->slabs != NULL) {
+        return NULL;
+    }
+    logger->page_table = pool->base_table;
+    logger->pool = NULL;
+    return pool;
+}
+
+int logger_shrink(LoggerHandler logger)
+{
+    if (logger == NULL) {
+        return -1;
+    }
+
+    logger_slab *released = NULL;
+    struct logger_group_t *group = NULL;
+    int pages = 0;
+    logger_rotate_lock(logger);
+    struct logger_pool *pool = logger->pool;
+    if (pool != NULL) {
+        group = pool->group;
+        // A slab goes once it stayed idle and untouched since the previous call, so no
+        // producer still holds one of its pages from before it became idle
+        int releasable = 1;
+        logger_slab **link = &pool->slabs;
+        while (*link != NULL) {
+            logger_slab *slab = *link;
+            const int idle = slab_idle(logger, pool, slab);
+            const unsigned int epochs = slab_epochs(pool, slab);
+            const int ready = idle && slab->idle && slab->epochs == epochs;
+            slab->idle = idle;
+            slab->epochs = epochs;
+
+            if (releasable && ready) {
+                *link = slab->next;
+                slab_unlink(logger, pool, slab);
+                slab->next = released;
+                released = slab;
+                pages += slab->count;
+                continue;
+            }
+            releasable = 0; // Older slabs keep their indices
+            link = &slab->next;
+        }
+        pool = pool_detach(logger);
+    }
+    logger_rotate_unlock(logger);
+
+    while (released != NULL) {
+        logger_slab *next = released->next;
+        pool_slab_free(group, released);
+        released = next;
+    }
+    if (pool != NULL) {
+        freev(pool);
+    }
+    return pages;
+}
+
+static int pool_configure(LoggerHandler logger, const logger_growth_t *growth, struct logger_group_t *group)
+{
+    if (growth == NULL) {
+        logger_rotate_lock(logger);
+        if (logger->pool != NULL) {
+            logger->pool->enabled = 0;
+        }
+        struct logger_pool *old = pool_detach(logger);
+        logger_rotate_unlock(logger);
+        if (old != NULL) {
+            freev(old);
+        }
+        return 0;
+    }
+
+    const size_t slab_size = pool_slab_size(logger, growth->slab_pages);
+    const int slabs = (int)(growth->max_bytes / slab_size);
+
+    // Sized once for every page the cap allows, so growth never moves the table
+    struct logger_pool *old = logger->pool;
+    const int base_pages = old != NULL ? old->base_pages : logger->total_pages;
+    int capacity = base_pages + slabs * growth->slab_pages;
+    if (old != NULL && capacity < old->capacity) {
+        capacity = old->capacity; // Cap lowered, keeps room for what was grown already
+    }
+
+    struct logger_pool *pool = mallocv(sizeof(struct logger_pool) + capacity * sizeof(page_list *));
+    if (pool == NULL) {
+        return -1;
+    }
+    pool->config = *growth;
+    pool->enabled = 1;
+    pool->base_pages = base_pages;
+    pool->capacity = capacity;
+    pool->slab_size = slab_size;
+    pool->group = group;
+
+    logger_rotate_lock(logger);
+    const int total = logger->total_pages;
+    for (int i = 0; i < total; i++) {
+        pool->table[i] = logger->page_table[i];
+    }
+    for (int i = total; i < capacity; i++) {
+        pool->table[i] = NULL;
+    }
+    pool->bytes = old != NULL ? old->bytes : 0;
+    pool->slabs = old != NULL ? old->slabs : NULL;
+    pool->base_table = old != NULL ? old->base_table : logger->page_table;
+    logger->pool = pool;
+    logger->page_table = pool->table;
+    logger_rotate_unlock(logger);
+
+    if (old != NULL) {
+        freev(old);
+    }
+    return 0;
+}
+
+int logger_set_growth(LoggerHandler logger, const logger_growth_t *growth)
+{
+    if (logger == NULL || (logger->flags & LOGGER_FLAG_MAPPED)) {
+        return -1; // Added pages would not be part of the file
+    }
+    if (logger->pool != NULL && logger->pool->group != NULL) {
+        return -1; // Its group decides how it grows
+    }
+    if (growth != NULL && (growth->slab_pages <= 0 || growth->watermark < 0)) {
+        return -1;
+    }
+    return pool_configure(logger, growth, NULL);
+}
+
+int logger_pool_share(LoggerHandler logger, struct logger_group_t *group, int slab_pages, int slabs)
+{
+    logger_growth_t growth;
+    growth.slab_pages = slab_pages;
+    growth.max_bytes = (size_t)slabs * pool_slab_size(logger, slab_pages);
+    growth.watermark = 0;
+    return pool_configure(logger, &growth, group);
+}
+
+void logger_pool_free(LoggerHandler logger)
+{
+    struct logger_pool *pool = logger->pool;
+    if (pool == NULL) {
+        return;
+    }
+    logger->page_table = pool->base_table;
+    logger->pool = NULL;
+    while (pool->slabs != NULL) {
+        logger_slab *next = pool->slabs->next;
+        pool_slab_free(pool->group, pool->slabs);
+        pool->slabs = next;
+    }
+    freev(pool);
+}
@@ -0,0 +1,461 @@
+#include "logger_port.h"
+#include <stdlib.h>
+#include <time.h>
+#include <errno.h>
+#include <stdatomic.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__XTENSA__)
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netdb.h>
+#endif
+
+// Platform-specific malloc/free
+#if defined(__XTENSA__)
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+
+void *mallocv(int size) 
+{ 
+    return heap_caps_malloc(size, MALLOC_CAP_8BIT | MALLOC_CAP_DMA); 
+}
+
+void freev(void *object) 
+{ 
+    heap_caps_free(object); 
+}
+
+uint32_t LOGGER_ISR_ATTR logger_now_us(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+// --- Record clocks ---
+uint32_t LOGGER_ISR_ATTR logger_clock_us(void)
+{
+    return (uint32_t)esp_timer_get_time();
+}
+
+uint32_t LOGGER_ISR_ATTR logger_clock_coarse_us(void)
+{
+    return (uint32_t)esp_timer_get_time(); // No coarser source that is safe in interrupts
+}
+
+uint32_t LOGGER_ISR_ATTR logger_clock_cycles(void)
+{
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+
+uint32_t logger_now_ns(void)
+{
+    return (uint32_t)(esp_timer_get_time() * 1000);
+}
+
+// --- FreeRTOS tasks ---
+typedef struct {
+    void (*entry)(void *);
+    void *arg;
+    SemaphoreHandle_t done;
+} task_start_t;
+
+static void logger_task_trampoline(void *param)
+{
+    task_start_t start = *(task_start_t *)param;
+    freev(param);
+    start.entry(start.arg);
+    xSemaphoreGive(start.done);
+    vTaskDelete(NULL);
+}
+
+int logger_thread_start(logger_thread_t *thread, void (*entry)(void *), void *arg,
+                        const char *name, int stack_size, int priority)
+{
+    task_start_t *start = mallocv(sizeof(task_start_t));
+    if (start == NULL) {
+        return -1;
+    }
+    thread->done = xSemaphoreCreateBinary();
+    if (thread->done == NULL) {
+        freev(start);
+        return -1;
+    }
+    start->entry = entry;
+    start->arg = arg;
+    start->done = thread->done;
+
+    if (xTaskCreate(logger_task_trampoline, name, stack_size, start, priority, &thread->task) != pdPASS) {
+        vSemaphoreDelete(thread->done);
+        freev(start);
+        return -1;
+    }
+    return 0;
+}
+
+void logger_thread_join(logger_thread_t *thread)
+{
+    xSemaphoreTake(thread->done, portMAX_DELAY);
+    vSemaphoreDelete(thread->done);
+}
+
+void logger_sleep_ms(int ms)
+{
+    vTaskDelay(pdMS_TO_TICKS(ms) > 0 ? pdMS_TO_TICKS(ms) : 1);
+}
+
+int LOGGER_ISR_ATTR logger_thread_slot(void)
+{
+    return (int)xPortGetCoreID();
+}
+
+// No file system mapping on the target
+int logger_map_open(logger_map_t *map, const char *path, size_t length)
+{
+    (void)map;
+    (void)path;
+    (void)length;
+    return -1;
+}
+
+void logger_map_sync_async(logger_map_t *map, const void *addr, size_t length)
+{
+    (void)map;
+    (void)addr;
+    (void)length;
+}
+
+void logger_map_close(logger_map_t *map)
+{
+    (void)map;
+}
+
+int logger_sem_init(logger_sem_t *sem)
+{
+    *sem = xSemaphoreCreateCounting(0x7FFF, 0);
+    return *sem != NULL ? 0 : -1;
+}
+
+void logger_sem_destroy(logger_sem_t *sem)
+{
+    vSemaphoreDelete(*sem);
+}
+
+void logger_sem_post(logger_sem_t *sem)
+{
+    xSemaphoreGive(*sem);
+}
+
+void LOGGER_ISR_ATTR logger_sem_post_isr(logger_sem_t *sem)
+{
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(*sem, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR(); // The worker outranks the interrupted task
+    }
+}
+
+int logger_sem_wait(logger_sem_t *sem, int timeout_ms)
+{
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTake(*sem, ticks) == pdTRUE ? 0 : -1;
+}
+#else
+void *mallocv(int size) 
+{ 
+    return malloc(size); 
+}
+void freev(void *object) 
+{
+    free(object); 
+}
+
+uint32_t logger_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+}
+
+// --- Record clocks ---
+uint32_t logger_clock_us(void)
+{
+    return logger_now_us();
+}
+
+uint32_t logger_clock_coarse_us(void)
+{
+#if defined(CLOCK_MONOTONIC_COARSE)
+    // Read from the vDSO data page without touching the hardware clock
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000);
+#else
+    return logger_now_us();
+#endif
+}
+
+uint32_t logger_clock_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return (uint32_t)ticks;
+#else
+    return logger_now_ns();
+#endif
+}
+
+uint32_t logger_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+}
+
+// --- POSIX threads ---
+typedef struct {
+    void (*entry)(void *);
+    void *arg;
+} thread_start_t;
+
+static void *logger_thread_trampoline(void *param)
+{
+    thread_start_t start = *(thread_start_t *)param;
+    freev(param);
+    start.entry(start.arg);
+    return NULL;
+}
+
+int logger_thread_start(logger_thread_t *thread, void (*entry)(void *), void *arg,
+                        const char *name, int stack_size, int priority)
+{
+    (void)name;
+    (void)stack_size;
+    (void)priority;
+
+    thread_start_t *start = mallocv(sizeof(thread_start_t));
+    if (start == NULL) {
+        return -1;
+    }
+    start->entry = entry;
+    start->arg = arg;
+    if (pthread_create(thread, NULL, logger_thread_trampoline, start) != 0) {
+        freev(start);
+        return -1;
+    }
+    return 0;
+}
+
+void logger_thread_join(logger_thread_t *thread)
+{
+    pthread_join(*thread, NULL);
+}
+
+void logger_sleep_ms(int ms)
+{
+    struct timespec ts = { ms / 1000, (long)(ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+int logger_thread_slot(void)
+{
+    static atomic_int next_slot;
+    static _Thread_local int slot = -1;
+    if (slot < 0) {
+        slot = atomic_fetch_add_explicit(&next_slot, 1, memory_order_relaxed);
+    }
+    return slot;
+}
+
+// --- mmap ---
+int logger_map_open(logger_map_t *map, const char *path, size_t length)
+{
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (length == 0) {
+        length = (size_t)st.st_size;
+    }
+    else if ((size_t)st.st_size != length && ftruncate(fd, (off_t)length) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (length == 0) {
+        close(fd);
+        return -1; // Nothing to map
+    }
+
+    void *addr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    map->fd = fd;
+    map->addr = addr;
+    map->length = length;
+    return 0;
+}
+
+void logger_map_sync_async(logger_map_t *map, const void *addr, size_t length)
+{
+    (void)map;
+    // msync() wants a page aligned start
+    const uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t)addr & ~(page - 1);
+    msync((void *)start, (uintptr_t)addr + length - start, MS_ASYNC);
+}
+
+void logger_map_close(logger_map_t *map)
+{
+    msync(map->addr, map->length, MS_SYNC);
+    munmap(map->addr, map->length);
+    close(map->fd);
+}
+
+int logger_sem_init(logger_sem_t *sem)
+{
+    return sem_init(sem, 0, 0) == 0 ? 0 : -1;
+}
+
+void logger_sem_destroy(logger_sem_t *sem)
+{
+    sem_destroy(sem);
+}
+
+void logger_sem_post(logger_sem_t *sem)
+{
+    sem_post(sem);
+}
+
+void logger_sem_post_isr(logger_sem_t *sem)
+{
+    sem_post(sem); // Async-signal-safe
+}
+
+int logger_sem_wait(logger_sem_t *sem, int timeout_ms)
+{
+    if (timeout_ms < 0) {
+        while (sem_wait(sem) != 0) {
+            if (errno != EINTR) return -1;
+        }
+        return 0;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    while (sem_timedwait(sem, &deadline) != 0) {
+        if (errno != EINTR) return -1;
+    }
+    return 0;
+}
+#endif
+
+// --- Sockets, the BSD API of both lwIP and POSIX ---
+#if defined(MSG_NOSIGNAL)
+#define LOGGER_SEND_FLAGS MSG_NOSIGNAL // A closed TCP peer must not raise SIGPIPE
+#else
+#define LOGGER_SEND_FLAGS 0
+#endif
+
+int logger_socket_open(const char *host, int port, int stream)
+{
+    char service[8];
+    snprintf(service, sizeof(service), "%d", port);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = stream ? SOCK_STREAM : SOCK_DGRAM;
+    struct addrinfo *result;
+    if (getaddrinfo(host, service, &hints, &result) != 0) {
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo *ai = result; ai != NULL; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            break; // UDP only fixes the destination, TCP has its connection
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+
+    if (fd >= 0) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#if defined(SO_NOSIGPIPE)
+        const int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    }
+    return fd;
+}
+
+int logger_socket_send(int fd, const void *data, int length, int timeout_ms)
+{
+    for (;;) {
+        const int sent = (int)send(fd, data, length, LOGGER_SEND_FLAGS);
+        if (sent >= 0) {
+            return sent;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if ((errno != EAGAIN && errno != EWOULDBLOCK) || timeout_ms == 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        }
+
+        fd_set writable;
+        FD_ZERO(&writable);
+        FD_SET(fd, &writable);
+        struct timeval wait = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+        const int ready = select(fd + 1, NULL, &writable, NULL, timeout_ms < 0 ? NULL : &wait);
+        if (ready == 0) {
+            return 0; // Still full
+        }
+        if (ready < 0 && errno != EINTR) {
+            return -1;
+        }
+        if (timeout_ms > 0) {
+            timeout_ms = 0; // One wait per call, the caller keeps its own deadline
+        }
+    }
+}
+
+void logger_socket_close(int fd)
+{
+    if (fd >= 0) {
+        close(fd);
+    }
+}
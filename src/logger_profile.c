@@ -0,0 +1,85 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_port.h"
+#include <stdatomic.h>
+#include <string.h>
+
+// --- Profiling counters ---
+// Shared by every logger of the program: the logger struct has to fit the base size
+// of static arenas, and a profile is read for the whole library anyway. Threads add
+// to one of a few slots picked by logger_thread_slot(), each on its own cache lines,
+// so producers timing their appends do not contend on a single counter.
+
+#ifndef LOGGER_PROFILE_SLOTS
+#define LOGGER_PROFILE_SLOTS 8
+#endif
+
+typedef struct {
+    atomic_ulong calls;
+    atomic_ullong cycles;
+    atomic_ulong max_cycles;
+} profile_counter;
+
+typedef struct {
+    profile_counter paths[LOGGER_PROFILE_PATHS];
+    char gap[LOGGER_CACHE_LINE_SIZE];
+} profile_slot;
+
+#if LOGFLOW_PROFILE
+static profile_slot profile_slots[LOGGER_PROFILE_SLOTS];
+
+void logger_profile_add(logger_profile_path path, uint32_t cycles)
+{
+    profile_counter *counter = &profile_slots[logger_thread_slot() % LOGGER_PROFILE_SLOTS].paths[path];
+    atomic_fetch_add_explicit(&counter->calls, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counter->cycles, cycles, memory_order_relaxed);
+    unsigned long max = atomic_load_explicit(&counter->max_cycles, memory_order_relaxed);
+    while (cycles > max
+           && !atomic_compare_exchange_weak_explicit(&counter->max_cycles, &max, cycles,
+                                                     memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void profile_sum(logger_profile_path path, logger_profile_path_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < LOGGER_PROFILE_SLOTS; i++) {
+        profile_counter *counter = &profile_slots[i].paths[path];
+        out->calls += atomic_load_explicit(&counter->calls, memory_order_relaxed);
+        out->cycles += atomic_load_explicit(&counter->cycles, memory_order_relaxed);
+        const unsigned long max = atomic_load_explicit(&counter->max_cycles, memory_order_relaxed);
+        if (max > out->max_cycles) {
+            out->max_cycles = max;
+        }
+    }
+}
+#endif
+
+int logger_get_profile(logger_profile_t *profile)
+{
+    if (profile == NULL) {
+        return -1;
+    }
+    memset(profile, 0, sizeof(*profile));
+#if LOGFLOW_PROFILE
+    profile_sum(LOGGER_PROFILE_APPEND, &profile->append);
+    profile_sum(LOGGER_PROFILE_FLUSH, &profile->flush);
+    profile_sum(LOGGER_PROFILE_PRINT, &profile->print);
+    profile->enabled = 1;
+#endif
+    return 0;
+}
+
+void logger_reset_profile(void)
+{
+#if LOGFLOW_PROFILE
+    for (int i = 0; i < LOGGER_PROFILE_SLOTS; i++) {
+        for (int path = 0; path < LOGGER_PROFILE_PATHS; path++) {
+            profile_counter *counter = &profile_slots[i].paths[path];
+            atomic_store_explicit(&counter->calls, 0, memory_order_relaxed);
+            atomic_store_explicit(&counter->cycles, 0, memory_order_relaxed);
+            atomic_store_explicit(&counter->max_cycles, 0, memory_order_relaxed);
+        }
+    }
+#endif
+}
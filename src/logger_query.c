@@ -0,0 +1,165 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include <stdatomic.h>
+
+// --- Queries over the page summaries ---
+// A page is only read when its summary may hold a match: a level of the mask was
+// counted, its time span meets the range and, for tag queries, the tag bits are
+// set in its bloom filter. Everything else costs a few loads per page.
+
+typedef struct {
+    uint32_t rank_mask;         // LOGFLOW_LEVEL_* ranks selected by the level mask
+    const logger_time_range_t *range;
+    uint16_t tag;               // logger_tag_hash(), 0 for any record
+    logger_record_fn fn;
+    void *ctx;
+} query_t;
+
+static uint32_t query_rank_mask(uint32_t level_mask)
+{
+    uint32_t ranks = 0;
+    for (int type = PAGE_TYPE_ERROR; type <= PAGE_TYPE_WARNING; type++) {
+        if (level_mask & LOGGER_LEVEL_MASK(type)) {
+            ranks |= 1u << LOGFLOW_LEVEL_RANK(type);
+        }
+    }
+    return ranks;
+}
+
+// Relative to from, the range is [0, to - from] and stays ordered across the wrap
+static int range_holds(const logger_time_range_t *range, uint32_t timestamp)
+{
+    return timestamp - range->from_us <= range->to_us - range->from_us;
+}
+
+// The span [first, last] meets the range when it starts inside it or covers its start
+static int range_meets(const logger_time_range_t *range, uint32_t first, uint32_t last)
+{
+    return range_holds(range, first) || range->from_us - first <= last - first;
+}
+
+static int query_page_may_match(const query_t *query, page_list *page)
+{
+#if LOGFLOW_INDEX
+    const page_summary *summary = &page->summary;
+    uint32_t ranks = 0;
+    for (int rank = 0; rank < LOGFLOW_LEVEL_NONE; rank++) {
+        if (atomic_load_explicit(&summary->counts[rank], memory_order_relaxed) > 0) {
+            ranks |= 1u << rank;
+        }
+    }
+    if ((ranks & query->rank_mask) == 0) {
+        return 0;
+    }
+    if (query->tag != 0) {
+        const uint32_t bits = logger_tag_bloom(query->tag);
+        if ((atomic_load_explicit(&summary->tags, memory_order_relaxed) & bits) != bits) {
+            return 0;
+        }
+    }
+    if (query->range != NULL) {
+        const uint32_t first = atomic_load_explicit(&summary->first, memory_order_relaxed);
+        const uint32_t last = atomic_load_explicit(&summary->last, memory_order_relaxed);
+        if (first > last || !range_meets(query->range, summary->opened + first, summary->opened + last)) {
+            return 0;
+        }
+    }
+#else
+    (void)query;
+    (void)page;
+#endif
+    return 1;
+}
+
+// Returns -1 once the callback asked to stop, the number of matches otherwise
+static int query_page(LoggerHandler logger, const query_t *query, page_list *page)
+{
+    const int index = logger_page_index(logger, page);
+    char rendered[LOGGER_LINE_RENDER_SIZE];
+    int matches = 0;
+    int offset = 0;
+    const record_header *header;
+    while ((header = page_next_record(logger, page, &offset)) != NULL) {
+        if (!(query->rank_mask & (1u << LOGFLOW_LEVEL_RANK(header->level)))
+            || (query->tag != 0 && header->tag != query->tag)
+            || (query->range != NULL && !range_holds(query->range, header->timestamp))) {
+            continue;
+        }
+        logger_record_t record;
+        record.timestamp = header->timestamp;
+        record.level = (page_type_t)header->level;
+        record.page = index;
+        record.length = logger_record_text(page, header, rendered, &record.data);
+        matches++;
+        if (query->fn(query->ctx, &record)) {
+            return -matches - 1;
+        }
+    }
+    return matches;
+}
+
+static int query_run(LoggerHandler logger, const query_t *query)
+{
+    int matches = 0;
+    page_list *first = logger_oldest_page(logger);
+    page_list *current = first;
+    do {
+        if (atomic_load_explicit(&current->format, memory_order_acquire) == PAGE_FORMAT_RECORD
+            && query_page_may_match(query, current)) {
+            const int found = query_page(logger, query, current);
+            if (found < 0) {
+                return matches - found - 1; // Stopped by the callback
+            }
+            matches += found;
+        }
+        current = page_next(logger, current);
+    } while (current != first);
+    return matches;
+}
+
+int logger_query(LoggerHandler logger, uint32_t level_mask, const logger_time_range_t *range,
+                 logger_record_fn fn, void *ctx)
+{
+    return logger_query_tag(logger, NULL, level_mask, range, fn, ctx);
+}
+
+int logger_query_tag(LoggerHandler logger, const char *tag, uint32_t level_mask,
+                     const logger_time_range_t *range, logger_record_fn fn, void *ctx)
+{
+    if (logger == NULL || fn == NULL) {
+        return -1;
+    }
+    query_t query;
+    query.rank_mask = query_rank_mask(level_mask);
+    query.range = range;
+    query.tag = tag != NULL ? logger_tag_hash(tag) : 0;
+    query.fn = fn;
+    query.ctx = ctx;
+    return query_run(logger, &query);
+}
+
+int logger_get_page_summary(LoggerHandler logger, int page_index, logger_page_summary_t *out)
+{
+    page_list *page = logger_get_page(logger, page_index);
+    if (page == NULL || out == NULL
+        || atomic_load_explicit(&page->format, memory_order_acquire) != PAGE_FORMAT_RECORD) {
+        return -1;
+    }
+    const page_summary *summary = &page->summary;
+    out->records = 0;
+    for (int rank = 0; rank < LOGFLOW_LEVEL_NONE; rank++) {
+        out->counts[rank] = atomic_load_explicit(&summary->counts[rank], memory_order_relaxed);
+        out->records += (int)out->counts[rank];
+    }
+    const uint32_t first = atomic_load_explicit(&summary->first, memory_order_relaxed);
+    const uint32_t last = atomic_load_explicit(&summary->last, memory_order_relaxed);
+    if (first <= last) {
+        out->first_us = summary->opened + first;
+        out->last_us = summary->opened + last;
+    }
+    else {
+        out->first_us = out->last_us = summary->opened + LOGGER_SUMMARY_BACKDATE_US; // Empty, when it was opened
+    }
+    out->tags = atomic_load_explicit(&summary->tags, memory_order_relaxed);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "logger_scan.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define LOGGER_SCAN_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LOGGER_SCAN_NEON 1
+#endif
+
+#define SCAN_BLOCK 16
+
+// --- Find ---
+const char *logger_scan_byte(const char *data, int length, char c)
+{
+    const char *p = data;
+    const char *end = data + length;
+
+#if defined(LOGGER_SCAN_SSE2)
+    const __m128i needle = _mm_set1_epi8(c);
+    for (; end - p >= SCAN_BLOCK; p += SCAN_BLOCK) {
+        const __m128i block = _mm_loadu_si128((const __m128i *)p);
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#elif defined(LOGGER_SCAN_NEON)
+    const uint8x16_t needle = vdupq_n_u8((uint8_t)c);
+    for (; end - p >= SCAN_BLOCK; p += SCAN_BLOCK) {
+        const uint8x16_t hits = vceqq_u8(vld1q_u8((const uint8_t *)p), needle);
+        if (vmaxvq_u8(hits) != 0) {
+            break; // The tail loop pins down the exact byte
+        }
+    }
+#else
+    return memchr(data, c, length); // The C library already has the best scalar version
+#endif
+
+    for (; p < end; p++) {
+        if (*p == c) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// --- Count ---
+int logger_count_byte(const char *data, int length, char c)
+{
+    const char *p = data;
+    const char *end = data + length;
+    int count = 0;
+
+#if defined(LOGGER_SCAN_SSE2)
+    const __m128i needle = _mm_set1_epi8(c);
+    for (; end - p >= SCAN_BLOCK; p += SCAN_BLOCK) {
+        const __m128i block = _mm_loadu_si128((const __m128i *)p);
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+    }
+#elif defined(LOGGER_SCAN_NEON)
+    const uint8x16_t needle = vdupq_n_u8((uint8_t)c);
+    while (end - p >= SCAN_BLOCK) {
+        // Byte lanes count up to 255 blocks before they are folded into the total
+        uint8x16_t lanes = vdupq_n_u8(0);
+        for (int blocks = 0; blocks < 255 && end - p >= SCAN_BLOCK; blocks++, p += SCAN_BLOCK) {
+            lanes = vsubq_u8(lanes, vceqq_u8(vld1q_u8((const uint8_t *)p), needle));
+        }
+        count += vaddlvq_u8(lanes);
+    }
+#else
+    // Eight bytes at a time: a lane becomes zero where it matched
+    const uint64_t ones = 0x0101010101010101ull;
+    const uint64_t highs = 0x8080808080808080ull;
+    const uint64_t pattern = ones * (uint8_t)c;
+    for (; end - p >= 8; p += 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        word ^= pattern;
+        // High bit set exactly in the zero lanes, without borrows across lanes
+        const uint64_t zero = ~(((word & ~highs) + ~highs) | word | ~highs);
+        count += __builtin_popcountll(zero);
+    }
+#endif
+
+    for (; p < end; p++) {
+        count += (*p == c);
+    }
+    return count;
+}
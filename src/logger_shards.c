@@ -0,0 +1,211 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_port.h"
+#include <stdatomic.h>
+#include <stdarg.h>
+
+// --- Sharded front-end ---
+// Every shard is a complete logger with its own allocation, head page and rotate
+// lock, so producers on different cores or threads never write the same cache
+// lines. The shard set itself is read-only after creation. Readers merge the
+// shards back into one timeline by record timestamp.
+
+struct logger_shards_t {
+    int count;
+    LoggerHandler loggers[];
+};
+
+// Read position inside one shard, walking its pages oldest first
+typedef struct {
+    LoggerHandler logger;
+    page_list *first;
+    page_list *page;                // NULL once every page was visited
+    int offset;
+    const record_header *record;    // Next record to merge, NULL when the shard is exhausted
+} shard_cursor;
+
+static LoggerShardsHandler logger_shards_create_internal(int shard_count, int page_amount, int page_size,
+                                                         LoggerHandler (*create)(int, int))
+{
+    if (shard_count <= 0) {
+        return NULL;
+    }
+
+    LoggerShardsHandler shards = mallocv(sizeof(struct logger_shards_t) + shard_count * sizeof(LoggerHandler));
+    if (shards == NULL) {
+        return NULL;
+    }
+    shards->count = 0;
+    for (int i = 0; i < shard_count; i++) {
+        shards->loggers[i] = create(page_amount, page_size);
+        if (shards->loggers[i] == NULL) {
+            logger_shards_destroy(shards);
+            return NULL;
+        }
+        shards->count++;
+    }
+    return shards;
+}
+
+LoggerShardsHandler logger_shards_create(int shard_count, int page_amount, int page_size)
+{
+    return logger_shards_create_internal(shard_count, page_amount, page_size, logger_create);
+}
+
+LoggerShardsHandler logger_shards_create_ring(int shard_count, int page_amount, int page_size)
+{
+    return logger_shards_create_internal(shard_count, page_amount, page_size, logger_create_ring);
+}
+
+void logger_shards_destroy(LoggerShardsHandler shards)
+{
+    if (shards == NULL) {
+        return;
+    }
+    for (int i = 0; i < shards->count; i++) {
+        logger_destroy(shards->loggers[i]);
+    }
+    freev(shards);
+}
+
+int logger_shards_count(LoggerShardsHandler shards)
+{
+    return shards != NULL ? shards->count : 0;
+}
+
+LoggerHandler logger_shards_get(LoggerShardsHandler shards, int index)
+{
+    if (shards == NULL || index < 0 || index >= shards->count) {
+        return NULL;
+    }
+    return shards->loggers[index];
+}
+
+LoggerHandler logger_shards_local(LoggerShardsHandler shards)
+{
+    if (shards == NULL) {
+        return NULL;
+    }
+    return shards->loggers[logger_thread_slot() % shards->count];
+}
+
+int logger_shards_write(LoggerShardsHandler shards, const char *data, int size)
+{
+    return logger_write(logger_shards_local(shards), data, size);
+}
+
+int logger_shards_log(LoggerShardsHandler shards, page_type_t level, const char *data, int size)
+{
+    return logger_log(logger_shards_local(shards), level, data, size);
+}
+
+int logger_shards_logf_deferred(LoggerShardsHandler shards, page_type_t level, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int result = logger_vlogf_deferred(logger_shards_local(shards), level, fmt, args);
+    va_end(args);
+    return result;
+}
+
+void logger_shards_set_sink(LoggerShardsHandler shards, const logger_sink_t *sink)
+{
+    if (shards == NULL) {
+        return;
+    }
+    for (int i = 0; i < shards->count; i++) {
+        logger_set_sink(shards->loggers[i], sink);
+    }
+}
+
+void logger_shards_set_level(LoggerShardsHandler shards, page_type_t min_level)
+{
+    if (shards == NULL) {
+        return;
+    }
+    for (int i = 0; i < shards->count; i++) {
+        logger_set_level(shards->loggers[i], min_level);
+    }
+}
+
+// --- Merged readout ---
+// Moves the cursor to the next committed record matching level_mask
+static void shard_cursor_advance(shard_cursor *cursor, uint32_t level_mask)
+{
+    cursor->record = NULL;
+    while (cursor->page != NULL) {
+        if (atomic_load_explicit(&cursor->page->format, memory_order_acquire) == PAGE_FORMAT_RECORD) {
+            const record_header *record;
+            while ((record = page_next_record(cursor->logger, cursor->page, &cursor->offset)) != NULL) {
+                if (record_matches(record, level_mask)) {
+                    cursor->record = record;
+                    return;
+                }
+            }
+        }
+        cursor->page = page_next(cursor->logger, cursor->page);
+        cursor->offset = 0;
+        if (cursor->page == cursor->first) {
+            cursor->page = NULL; // Wrapped around, shard exhausted
+        }
+    }
+}
+
+// Calls emit for every matching record of every shard, oldest first
+void logger_shards_merge(LoggerShardsHandler shards, uint32_t level_mask,
+                         void (*emit)(void *ctx, int shard, const page_list *page, const record_header *record),
+                         void *ctx)
+{
+    shard_cursor *cursors = mallocv(shards->count * sizeof(shard_cursor));
+    if (cursors == NULL) {
+        return;
+    }
+    for (int i = 0; i < shards->count; i++) {
+        shard_cursor *cursor = &cursors[i];
+        cursor->logger = shards->loggers[i];
+        cursor->first = logger_oldest_page(cursor->logger);
+        cursor->page = cursor->first;
+        cursor->offset = 0;
+        shard_cursor_advance(cursor, level_mask);
+    }
+
+    // Shard counts are small, a linear scan for the oldest head beats a heap here
+    for (;;) {
+        shard_cursor *oldest = NULL;
+        for (int i = 0; i < shards->count; i++) {
+            if (cursors[i].record != NULL && (oldest == NULL || record_before(cursors[i].record, oldest->record))) {
+                oldest = &cursors[i];
+            }
+        }
+        if (oldest == NULL) {
+            break;
+        }
+        emit(ctx, (int)(oldest - cursors), oldest->page, oldest->record);
+        shard_cursor_advance(oldest, level_mask);
+    }
+    freev(cursors);
+}
+
+static void logger_shards_print_one(void *ctx, int shard, const page_list *page, const record_header *record)
+{
+    (void)shard;
+    logger_out *out = ctx;
+    logger_print_record(out, page, record);
+    logger_out_write(out, "\n", 1);
+}
+
+void logger_shards_print_filtered(LoggerShardsHandler shards, uint32_t level_mask)
+{
+    if (shards == NULL) {
+        return;
+    }
+    logger_out out;
+    logger_out_init(&out, shards->loggers[0]); // Every shard shares the sink
+    logger_shards_merge(shards, level_mask, logger_shards_print_one, &out);
+    logger_out_end(&out);
+}
+
+void logger_shards_print_all(LoggerShardsHandler shards)
+{
+    logger_shards_print_filtered(shards, LOGGER_LEVEL_ALL);
+}
@@ -0,0 +1,96 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include "logger_port.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// --- Tag registry ---
+// Registered tags are kept by pointer in an open-addressed table keyed by their
+// logger_tag_hash(), which is also what records and page bloom filters carry, so a
+// tagged record needs no more than the header it already has. The table is shared
+// by every logger of the program and only ever grows: lookups take no lock, an entry
+// is complete once its name pointer is published.
+
+#ifndef LOGGER_TAGS_MAX
+#define LOGGER_TAGS_MAX 64          // Registered tags per program
+#endif
+
+#define TAG_TABLE_SIZE (LOGGER_TAGS_MAX * 2) // At most half full, probes stay short
+
+typedef struct {
+    _Atomic(const char *) name; // NULL while free, published last
+    int length;
+    uint16_t hash;
+} tag_entry;
+
+static tag_entry tag_table[TAG_TABLE_SIZE];
+static int tag_count;               // Written under tag_lock only
+static atomic_flag tag_lock = ATOMIC_FLAG_INIT;
+
+static const tag_entry *tag_find(uint16_t hash)
+{
+    for (unsigned int i = hash % TAG_TABLE_SIZE;; i = (i + 1) % TAG_TABLE_SIZE) {
+        const tag_entry *entry = &tag_table[i];
+        if (atomic_load_explicit(&entry->name, memory_order_acquire) == NULL) {
+            return entry; // Free, the hash is not registered
+        }
+        if (entry->hash == hash) {
+            return entry;
+        }
+    }
+}
+
+int logger_tag_register(const char *tag)
+{
+    if (tag == NULL || tag[0] == '\0') {
+        return -1;
+    }
+    const uint16_t hash = logger_tag_hash(tag);
+    const int length = (int)strlen(tag);
+
+    while (atomic_flag_test_and_set_explicit(&tag_lock, memory_order_acquire)) {
+        logger_sleep_ms(1); // Another thread is registering, that is quick
+    }
+    int result = hash;
+    tag_entry *entry = (tag_entry *)tag_find(hash);
+    const char *name = atomic_load_explicit(&entry->name, memory_order_relaxed);
+    if (name != NULL) {
+        if (name != tag && strcmp(name, tag) != 0) {
+            result = -1; // Another tag took this hash
+        }
+    }
+    else if (tag_count == LOGGER_TAGS_MAX) {
+        result = -1;
+    }
+    else {
+        entry->length = length;
+        entry->hash = hash;
+        atomic_store_explicit(&entry->name, tag, memory_order_release);
+        tag_count++;
+    }
+    atomic_flag_clear_explicit(&tag_lock, memory_order_release);
+    return result;
+}
+
+const char *logger_tag_lookup(uint16_t hash, int *length)
+{
+    const tag_entry *entry = tag_find(hash);
+    const char *name = atomic_load_explicit(&entry->name, memory_order_acquire);
+    if (name != NULL && length != NULL) {
+        *length = entry->length;
+    }
+    return name;
+}
+
+int logger_tag_text(uint16_t hash, char *unknown, const char **text)
+{
+    int length;
+    *text = logger_tag_lookup(hash, &length);
+    if (*text != NULL) {
+        return length;
+    }
+    // Written by another program, e.g. an adopted arena, or before a restart
+    *text = unknown;
+    return snprintf(unknown, LOGGER_TAG_UNKNOWN_SIZE, "#%04x", (unsigned int)hash);
+}
@@ -0,0 +1,271 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Throughput and corruption regression test, run by ctest.
+//
+// Producer threads log self-checking records into one logger while the drain
+// worker writes the pages to a sink that parses every line back. The run fails
+// when a line is torn or lost, when a producer's records arrive out of order,
+// when the page layout is broken afterwards, or when fewer records per second
+// than the floor were accepted.
+//
+// ctest --output-on-failure
+// ./logger_stress [min records/s], or LOGFLOW_STRESS_MIN_RATE=<records/s>
+
+#define PRODUCERS 4
+#define RECORDS_PER_PRODUCER 200000
+#define PAGES 16
+#define PAGE_SIZE 8192
+#define DEFAULT_MIN_RATE 25000.0  // Unoptimized build on one core, pass a higher floor on bench machines
+#define LINE_MAX_SIZE 256
+
+typedef struct {
+    pthread_mutex_t lock;
+    char line[LINE_MAX_SIZE];
+    int line_length;
+    long delivered[PRODUCERS];
+    long last_seq[PRODUCERS];
+    long corrupt;
+} check_sink;
+
+typedef struct {
+    LoggerHandler logger;
+    int id;
+    long accepted;
+} producer_t;
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Filler length and checksum both follow from the producer and the sequence number
+static int filler_length(long seq)
+{
+    return (int)(seq % 41);
+}
+
+static unsigned int record_check(int id, long seq)
+{
+    return ((unsigned int)id * 2654435761u) ^ (unsigned int)seq ^ ((unsigned int)seq >> 7);
+}
+
+// --- Sink parsing the drained lines ---
+static void check_line(check_sink *sink, const char *line, int length)
+{
+    if (length == 0) {
+        return; // Page separator
+    }
+    const char *payload = memchr(line, '@', length);
+    int id;
+    long seq;
+    unsigned int check;
+    int consumed;
+    if (payload == NULL || sscanf(payload, "@%d %ld %x %n", &id, &seq, &check, &consumed) != 3
+        || id < 0 || id >= PRODUCERS || check != record_check(id, seq)) {
+        sink->corrupt++;
+        return;
+    }
+    const char *filler = payload + consumed;
+    const int expected = filler_length(seq);
+    if (line + length - filler != expected) {
+        sink->corrupt++;
+        return;
+    }
+    for (int i = 0; i < expected; i++) {
+        if (filler[i] != 'a' + id) {
+            sink->corrupt++;
+            return;
+        }
+    }
+    if (seq <= sink->last_seq[id]) {
+        sink->corrupt++; // Reordered or delivered twice
+        return;
+    }
+    sink->last_seq[id] = seq;
+    sink->delivered[id]++;
+}
+
+static int check_sink_write(void *ctx, const char *data, int length)
+{
+    check_sink *sink = ctx;
+    pthread_mutex_lock(&sink->lock);
+    for (int i = 0; i < length; i++) {
+        if (data[i] == '\n') {
+            check_line(sink, sink->line, sink->line_length);
+            sink->line_length = 0;
+        }
+        else if (sink->line_length < LINE_MAX_SIZE) {
+            sink->line[sink->line_length++] = data[i];
+        }
+        else {
+            sink->corrupt++; // Runaway line, a record lost its terminator
+            sink->line_length = 0;
+        }
+    }
+    pthread_mutex_unlock(&sink->lock);
+    return length;
+}
+
+// --- Producers ---
+static void *producer_main(void *arg)
+{
+    producer_t *producer = arg;
+    char filler[64];
+    memset(filler, 'a' + producer->id, sizeof(filler));
+    char message[LINE_MAX_SIZE];
+    for (long seq = 0; seq < RECORDS_PER_PRODUCER; seq++) {
+        const int length = snprintf(message, sizeof(message), "@%d %ld %x %.*s", producer->id, seq,
+                                    record_check(producer->id, seq), filler_length(seq), filler);
+        if (logger_log(producer->logger, PAGE_TYPE_INFO, message, length) >= 0) {
+            producer->accepted++;
+        }
+    }
+    return NULL;
+}
+
+// --- Layout checks, what logger_debug_dump() prints but asserted ---
+static int check_layout(LoggerHandler logger)
+{
+    const uintptr_t start = (uintptr_t)logger;
+    const uintptr_t end = start + logger->alloc_size;
+    int failures = 0;
+    int index = 0;
+    page_list *current;
+    list_for_each_entry(current, &logger->pages.list, list) {
+        const uintptr_t entry = (uintptr_t)current;
+        const uintptr_t buffer = (uintptr_t)current->buffer;
+        if (index >= logger->total_pages || logger->page_table[index] != current) {
+            printf("page %d: list and page table disagree\n", index);
+            return failures + 1;
+        }
+        if (entry % ALIGNOF(page_list) != 0 || buffer % (uintptr_t)logger->buffer_alignment != 0) {
+            printf("page %d: misaligned entry %p or buffer %p\n", index, (void *)entry, (void *)buffer);
+            failures++;
+        }
+        if (entry < start || entry + sizeof(page_list) > end
+            || buffer < start || buffer + logger->page_buffer_size > end) {
+            printf("page %d: outside the arena\n", index);
+            failures++;
+        }
+        if (current->list.next->prev != &current->list || current->list.prev->next != &current->list) {
+            printf("page %d: broken list links\n", index);
+            failures++;
+        }
+        for (int other = 0; other < index; other++) {
+            const page_list *page = logger->page_table[other];
+            const uintptr_t other_buffer = (uintptr_t)page->buffer;
+            if ((buffer < other_buffer + logger->page_buffer_size && other_buffer < buffer + logger->page_buffer_size)
+                || (entry < other_buffer + logger->page_buffer_size && other_buffer < entry + sizeof(page_list))) {
+                printf("page %d: overlaps page %d\n", index, other);
+                failures++;
+            }
+        }
+        index++;
+    }
+    if (index != logger->total_pages) {
+        printf("%d pages linked, %d expected\n", index, logger->total_pages);
+        failures++;
+    }
+    return failures;
+}
+
+static void print_profile_path(const char *name, const logger_profile_path_t *path)
+{
+    printf("  %-7s %10lu calls %10.1f cycles avg %10lu max\n", name, path->calls,
+           path->calls > 0 ? (double)path->cycles / path->calls : 0.0, path->max_cycles);
+}
+
+int main(int argc, char **argv)
+{
+    double min_rate = DEFAULT_MIN_RATE;
+    const char *rate = argc > 1 ? argv[1] : getenv("LOGFLOW_STRESS_MIN_RATE");
+    if (rate != NULL) {
+        min_rate = atof(rate);
+    }
+
+    LoggerHandler logger = logger_create(PAGES, PAGE_SIZE);
+    if (logger == NULL) {
+        printf("FAIL: logger_create\n");
+        return 1;
+    }
+    check_sink sink;
+    memset(&sink, 0, sizeof(sink));
+    pthread_mutex_init(&sink.lock, NULL);
+    for (int i = 0; i < PRODUCERS; i++) {
+        sink.last_seq[i] = -1;
+    }
+    const logger_sink_t output = { check_sink_write, &sink, NULL };
+    logger_set_sink(logger, &output);
+    if (logger_drain_start(logger, NULL) != 0) {
+        printf("FAIL: logger_drain_start\n");
+        return 1;
+    }
+    logger_reset_profile();
+
+    pthread_t threads[PRODUCERS];
+    producer_t producers[PRODUCERS];
+    const uint64_t begin = now_ns();
+    for (int i = 0; i < PRODUCERS; i++) {
+        producers[i].logger = logger;
+        producers[i].id = i;
+        producers[i].accepted = 0;
+        pthread_create(&threads[i], NULL, producer_main, &producers[i]);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    const double seconds = (now_ns() - begin) / 1e9;
+    logger_drain_sync(logger);
+    logger_drain_stop(logger);
+
+    int failures = 0;
+    long accepted = 0;
+    long delivered = 0;
+    for (int i = 0; i < PRODUCERS; i++) {
+        accepted += producers[i].accepted;
+        delivered += sink.delivered[i];
+        if (sink.delivered[i] != producers[i].accepted) {
+            printf("FAIL: producer %d: %ld records accepted, %ld delivered\n", i,
+                   producers[i].accepted, sink.delivered[i]);
+            failures++;
+        }
+    }
+    if (sink.corrupt != 0 || sink.line_length != 0) {
+        printf("FAIL: %ld corrupt lines, %d bytes of a torn line left\n", sink.corrupt, sink.line_length);
+        failures++;
+    }
+    const double accepted_rate = accepted / seconds;
+    printf("%d producers: %ld of %ld records accepted in %.3f s, %.0f records/s, %ld delivered\n",
+           PRODUCERS, accepted, (long)PRODUCERS * RECORDS_PER_PRODUCER, seconds, accepted_rate, delivered);
+    if (accepted_rate < min_rate) {
+        printf("FAIL: below the floor of %.0f records/s\n", min_rate);
+        failures++;
+    }
+    const int layout = check_layout(logger);
+    if (layout != 0) {
+        printf("FAIL: %d layout errors\n", layout);
+        failures++;
+    }
+
+    logger_profile_t profile;
+    if (logger_get_profile(&profile) == 0 && profile.enabled) {
+        printf("Profile:\n");
+        print_profile_path("append", &profile.append);
+        print_profile_path("flush", &profile.flush);
+        print_profile_path("print", &profile.print);
+    }
+
+    logger_destroy(logger);
+    pthread_mutex_destroy(&sink.lock);
+    printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
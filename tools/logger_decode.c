@@ -0,0 +1,98 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Decodes a stream written by logger_export() back into readable text.
+//
+// Input is consumed in small reads and fed to the streaming decoder, so it works
+// on a live serial port or socket as well as on a captured file. Records print
+// like logger_print_all() does; text pages print as they were written.
+//
+// ./logger_decode [file]      (stdin when no file is given)
+
+#define DECODE_READ_SIZE 4096
+#define DECODE_FRAME_CAPACITY (64 * 1024 + 64)  // Largest record a page can hold, with room for rendering
+#define DECODE_PAGE_SIZE_MAX (64 * 1024 * 1024)  // Bigger page sizes in a header are taken as corruption
+
+typedef struct {
+    logger_decoder_t decoder;
+    int streams;
+} decode_state;
+
+// Compressed pages are decompressed inside the frame buffer, size it for the pages of this stream
+static void decode_fit(decode_state *state, int page_size)
+{
+    if (page_size <= 0 || page_size > DECODE_PAGE_SIZE_MAX
+        || LOGGER_DECODER_ARCHIVE_SIZE(page_size) <= state->decoder.capacity) {
+        return;
+    }
+    const int capacity = LOGGER_DECODER_ARCHIVE_SIZE(page_size);
+    char *frame = realloc(state->decoder.buffer, capacity);
+    if (frame != NULL) {
+        state->decoder.buffer = frame;
+        state->decoder.capacity = capacity;
+    }
+}
+
+static void decode_item(void *ctx, const logger_export_item_t *item)
+{
+    decode_state *state = ctx;
+    switch (item->event) {
+        case LOGGER_EXPORT_HEADER:
+            printf("== stream v%d, %d pages of %d bytes ==\n", item->version, item->page_count, item->page_size);
+            decode_fit(state, item->page_size);
+            break;
+        case LOGGER_EXPORT_PAGE:
+            printf("-- page %d (%s) --\n", item->page_index, item->is_record ? "records" : "text");
+            break;
+        case LOGGER_EXPORT_TEXT:
+            fwrite(item->data, 1, item->length, stdout);
+            break;
+        case LOGGER_EXPORT_RECORD:
+            printf("[%lu] %s%.*s\n", (unsigned long)item->timestamp,
+                   logger_print_start_message_section((page_type_t)item->type), item->length, item->data);
+            break;
+        case LOGGER_EXPORT_END:
+            state->streams++;
+            break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (in == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    char *frame = malloc(DECODE_FRAME_CAPACITY);
+    if (frame == NULL) {
+        return 1;
+    }
+    char chunk[DECODE_READ_SIZE];
+    decode_state state;
+    state.streams = 0;
+    logger_decoder_init(&state.decoder, frame, DECODE_FRAME_CAPACITY, decode_item, &state);
+
+    int status = 0;
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+        if (logger_decoder_feed(&state.decoder, chunk, (int)n) != 0) {
+            fprintf(stderr, "corrupt stream after %d complete stream(s)\n", state.streams);
+            status = 1;
+            break;
+        }
+    }
+    if (status == 0 && state.decoder.have != 0) {
+        fprintf(stderr, "stream truncated\n");
+        status = 1;
+    }
+
+    free(state.decoder.buffer);
+    if (in != stdin) {
+        fclose(in);
+    }
+    return status;
+}
@@ -0,0 +1,154 @@
+#include "logger.h"
+#include "logger_internal.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Prints the records of a file written by logger_create_mapped(), optionally following it.
+//
+// The file is mapped read-only, so the producer is never slowed down nor copied from:
+// pages are located with the geometry of the persistent header and records are read in
+// place, stopping at the first one not committed yet.
+//
+// ./logger_tail <file> [-f]
+
+#define TAIL_POLL_MS 100
+
+typedef struct {
+    unsigned int epoch;     // Generation the offset belongs to
+    int offset;             // Records before this offset were printed already
+} page_cursor;
+
+// Prints what was committed on a page since the last call
+static void tail_page(const logger_persist *persist, const uint8_t *base, int index, page_cursor *cursor)
+{
+    uintptr_t entry_addr, buffer_addr;
+    logger_layout_page(persist, (uintptr_t)base, index, &entry_addr, &buffer_addr);
+    const page_list *page = (const page_list *)entry_addr;
+    const char *buffer = (const char *)buffer_addr;
+
+    unsigned int epoch = atomic_load_explicit(&page->epoch, memory_order_acquire);
+    if (epoch != cursor->epoch) {
+        cursor->epoch = epoch; // Flushed or rotated into since last time
+        cursor->offset = 0;
+    }
+
+    int used = atomic_load_explicit(&page->used, memory_order_acquire);
+    if (used > persist->page_size) {
+        used = persist->page_size;
+    }
+
+    unsigned char format = atomic_load_explicit(&page->format, memory_order_acquire);
+    if (format == PAGE_FORMAT_TEXT) {
+        if (used > cursor->offset) {
+            fwrite(buffer + cursor->offset, 1, used - cursor->offset, stdout);
+            cursor->offset = used;
+        }
+        return;
+    }
+    if (format != PAGE_FORMAT_RECORD) {
+        return;
+    }
+
+    const uint32_t tag = RECORD_COMMIT_TAG(epoch);
+    while (cursor->offset + (int)sizeof(record_header) <= used) {
+        const record_header *header = (const record_header *)(buffer + cursor->offset);
+        if (atomic_load_explicit(&header->commit, memory_order_acquire) != tag) {
+            break; // Not published yet
+        }
+        if (header->slot < sizeof(record_header) || cursor->offset + header->slot > persist->page_size) {
+            break; // Torn by a concurrent flush, picked up again next poll
+        }
+        if (header->kind == RECORD_KIND_TEXT) {
+            printf("[%lu] %s%.*s\n", (unsigned long)header->timestamp,
+                   logger_print_start_message_section((page_type_t)header->level), (int)header->length,
+                   RECORD_DATA(header));
+        }
+        else if (header->kind == RECORD_KIND_TAGGED) {
+            // Registered by the producer, so only known here when this build registers it too
+            char unknown[LOGGER_TAG_UNKNOWN_SIZE];
+            const char *name;
+            const int length = logger_tag_text(header->tag, unknown, &name);
+            printf("[%lu] %s%.*s: %.*s\n", (unsigned long)header->timestamp,
+                   logger_print_start_message_section((page_type_t)header->level), length, name,
+                   (int)header->length, RECORD_DATA(header));
+        }
+        else if (header->kind == RECORD_KIND_DEFERRED) {
+            // The format pointer belongs to the producer's address space
+            printf("[%lu] %s<deferred record, %u bytes>\n", (unsigned long)header->timestamp,
+                   logger_print_start_message_section((page_type_t)header->level), (unsigned)header->length);
+        }
+        cursor->offset += header->slot;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file> [-f]\n", argv[0]);
+        return 2;
+    }
+    const int follow = argc > 2 && strcmp(argv[2], "-f") == 0;
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    const uint8_t *base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    const struct logger_t *logger = (const struct logger_t *)base;
+    const logger_persist *persist = &logger->persist;
+    if (logger_persist_check(persist, st.st_size) != 0) {
+        fprintf(stderr, "%s: not a LogFlow file or from another version\n", argv[1]);
+        return 1;
+    }
+
+    const int pages = persist->page_amount;
+    page_cursor *cursors = calloc(pages, sizeof(page_cursor));
+    for (int i = 0; i < pages; i++) {
+        cursors[i].epoch = ~0u; // Matches no page yet
+    }
+
+    do {
+        // The head pointer is relative to where the producer mapped the file
+        const uintptr_t head = (uintptr_t)atomic_load_explicit(&logger->head, memory_order_acquire);
+        int head_index = 0;
+        for (int i = 0; i < pages; i++) {
+            uintptr_t entry, buffer;
+            logger_layout_page(persist, (uintptr_t)persist->base, i, &entry, &buffer);
+            if (entry == head) {
+                head_index = i;
+                break;
+            }
+        }
+
+        // Oldest page first: right after the head for rings, page 0 otherwise
+        const int first = (persist->flags & LOGGER_FLAG_RING) ? (head_index + 1) % pages : 0;
+        for (int n = 0; n < pages; n++) {
+            int index = (first + n) % pages;
+            tail_page(persist, base, index, &cursors[index]);
+        }
+        fflush(stdout);
+
+        if (follow) {
+            struct timespec ts = { 0, TAIL_POLL_MS * 1000000L };
+            nanosleep(&ts, NULL);
+        }
+    } while (follow);
+
+    free(cursors);
+    munmap((void *)base, st.st_size);
+    close(fd);
+    return 0;
+}